@@ -0,0 +1,68 @@
+/**
+ * @file allocator.h
+ * @brief Header file for memory resources (arena and pool allocators) built on std::pmr.
+ */
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace allocator {
+
+/**
+ * @brief Memory resource that counts the allocations passed through it, then forwards them to another resource.
+ *
+ * Put it upstream of an arena or pool to count how often they have to go back to the system for memory.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Creates the resource.
+     *
+     * @param std::pmr::memory_resource The resource to forward allocations to.
+     */
+    explicit CountingResource(std::pmr::memory_resource* = std::pmr::new_delete_resource());
+
+    /**
+     * @brief Gets the amount of allocations made so far.
+     *
+     * @return The amount of allocations.
+     */
+    size_t allocations() const;
+
+    /**
+     * @brief Gets the amount of bytes allocated so far, including memory that was freed since.
+     *
+     * @return The amount of bytes.
+     */
+    size_t bytesAllocated() const;
+
+private:
+    void* do_allocate(size_t, size_t) override;
+    void do_deallocate(void*, size_t, size_t) override;
+    bool do_is_equal(const std::pmr::memory_resource&) const noexcept override;
+
+    std::pmr::memory_resource* upstream; /**< The resource allocations are forwarded to */
+    size_t allocationCount = 0; /**< Amount of allocations */
+    size_t byteCount = 0; /**< Amount of bytes allocated */
+};
+
+/**
+ * @brief Gets this thread's pool of size classes. Small allocations are served from per-size free lists, so
+ * memory freed by one call is reused by the next without going back to the system. There's no locking, so the
+ * pool must only be used from the thread that got it.
+ *
+ * @return The pool for the calling thread.
+ */
+std::pmr::memory_resource* threadLocalPool();
+
+/**
+ * @brief Runs the code paths that accept a memory resource with and without an arena or pool, and logs how many
+ * allocations reached the system and how long each took.
+ */
+void demonstration();
+
+} // namespace allocator
+
+#endif
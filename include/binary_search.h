@@ -5,6 +5,9 @@
 #ifndef BINARY_SEARCH_H
 #define BINARY_SEARCH_H
 
+#include <cstddef>
+#include <functional>
+#include <random>
 #include <vector>
 
 namespace binary_search {
@@ -20,6 +23,91 @@ namespace binary_search {
  */
 int binarySearch(const std::vector<int>&, int);
 
+/**
+ * @brief Executes binary search iteratively on a window of an std::vector.
+ * 
+ * @param std::vector<int> The vector to search.
+ * @param int The value to search for.
+ * @param int The lowest index of the window.
+ * @param int The highest index of the window.
+ * @param int If not null, incremented once for every value of the vector that is compared to the target.
+ * 
+ * @return The index in the vector where the value was found. If the value wasn't found
+ * inside the window, it returns -1.
+ */
+int binarySearch(const std::vector<int>&, int, int, int, int* = nullptr);
+
+/**
+ * @brief Executes interpolation search on an std::vector, with a guarded fallback to binary search.
+ * 
+ * Instead of always probing the middle, it guesses where the target is from its value, which takes
+ * about log2(log2(n)) probes when the values are close to uniformly distributed. The guard makes sure
+ * skewed values can't take more than about 2 * log2(n) probes.
+ * 
+ * @param std::vector<int> The vector to search.
+ * @param int The value to search for.
+ * @param int If not null, incremented once for every value of the vector that is compared to the target.
+ * 
+ * @return The index in the vector where the value was found. If the value wasn't found,
+ * it returns -1.
+ */
+int interpolationSearch(const std::vector<int>&, int, int* = nullptr);
+
+/**
+ * @brief Executes exponential search on a sorted source whose length isn't known, ie. a stream or a
+ * file that's read on demand.
+ * 
+ * @param std::function<bool(int, int&)> Reads the value at an index into the int. Returns false if the
+ * index is past the end of the source.
+ * @param int The value to search for.
+ * @param int If not null, incremented once for every read of the source.
+ * 
+ * @return The index in the source where the value was found. If the value wasn't found,
+ * it returns -1.
+ */
+int exponentialSearch(const std::function<bool(int, int&)>&, int, int* = nullptr);
+
+/**
+ * @brief Shapes of sorted key sets, for comparing the search methods.
+ */
+enum class KeyDistribution {
+    Uniform, /**< Evenly spread keys, ie. sequential IDs with random gaps */
+    Zipfian, /**< Gaps between keys follow a Zipf distribution: mostly small, with rare very large jumps */
+    Clustered /**< Dense clusters of keys separated by huge gaps, ie. timestamps of bursts of events */
+};
+
+/**
+ * @brief Generates a sorted set of keys.
+ * 
+ * @param size_t The amount of keys.
+ * @param KeyDistribution How the keys are spread.
+ * @param std::mt19937 The Mersenne Twister random generator object.
+ * 
+ * @return The sorted keys.
+ */
+std::vector<int> generateSortedKeys(size_t, KeyDistribution, std::mt19937&);
+
+/**
+ * @brief Looks up the same keys with binary, interpolation and exponential search on each
+ * KeyDistribution, and logs the average probe count and latency of each.
+ * 
+ * @param size_t The amount of keys.
+ */
+void compareSearches(size_t);
+
+/**
+ * @brief Finds the first position in a window of a sorted array whose value is not less than the target.
+ * 
+ * @param arr The sorted array to search.
+ * @param int The value to search for.
+ * @param int The lowest index of the window.
+ * @param int The highest index of the window.
+ * 
+ * @return The index of the first value greater than or equal to the target. If every value in the
+ * window is less than the target, it returns the highest index + 1.
+ */
+int lowerBound(const int arr[], int, int, int);
+
 /**
  * @brief Executes binary search recursively on an std::vector.
  * 
@@ -5,6 +5,9 @@
 #ifndef BIT_MASK_H
 #define BIT_MASK_H
 
+#include <memory_resource>
+#include <string>
+
 namespace bit_mask {
 
     constexpr int BIT_SIZE = 4; /**< The amount of bits in the numbers that are processed in the examples */
@@ -58,6 +61,16 @@ namespace bit_mask {
      */
     std::string printDecimalAndBinaryRepresentation(const int);
 
+    /**
+     * @brief Same as above, but the string is allocated from a memory resource.
+     * 
+     * @param int The number to print.
+     * @param std::pmr::memory_resource The resource the string is allocated from.
+     * 
+     * @return The string containing both representations in easy-to-read formatting.
+     */
+    std::pmr::string printDecimalAndBinaryRepresentation(const int, std::pmr::memory_resource*);
+
     /**
      * @brief Demonstrates the Bit Mask concept.
      */
@@ -5,6 +5,7 @@
 #ifndef MERGE_SORT_H
 #define MERGE_SORT_H
 
+#include <memory_resource>
 #include <vector>
 #include "logger/log.h"
 
@@ -16,8 +17,9 @@ namespace merge_sort {
  * @param std::vector<int> The vector to sort.
  * @param int The first index of the left side.
  * @param int The last index of the right side.
+ * @param std::pmr::memory_resource The resource that merge's temporary vectors are allocated from.
  */
-void mergeSortRecursive(std::vector<int>&, int, int);
+void mergeSortRecursive(std::vector<int>&, int, int, std::pmr::memory_resource* = std::pmr::get_default_resource());
 
 /**
  * @brief This is the funcion that does the actual sorting and merging. It executes this on the
@@ -27,8 +29,35 @@ void mergeSortRecursive(std::vector<int>&, int, int);
  * @param int The first index of the left side.
  * @param int The index of the middle.
  * @param int The last index of the right side.
+ * @param std::pmr::memory_resource The resource the temporary vectors are allocated from.
  */
-void merge(std::vector<int>&, int, int, int);
+void merge(std::vector<int>&, int, int, int, std::pmr::memory_resource* = std::pmr::get_default_resource());
+
+/**
+ * @brief Merges any amount of sorted runs into one sorted output in a single pass, using a loser tree.
+ * 
+ * The run index is packed into 32 bits next to each value, so there can be at most UINT32_MAX runs.
+ * 
+ * @param arr Pointers to each sorted run.
+ * @param arr The size of each run.
+ * @param size_t The amount of runs, at most UINT32_MAX.
+ * @param arr The output array. Needs room for the sizes of all runs combined.
+ */
+void multiwayMerge(const int* const runs[], const size_t sizes[], const size_t, int out[]);
+
+/**
+ * @brief Same as multiwayMerge, but splits the output into equal parts and merges each part on its own thread.
+ * 
+ * The split points are found with binary_search::lowerBound, which takes int indexes, so each run can hold at most
+ * INT_MAX values. There can be at most UINT32_MAX runs, like multiwayMerge.
+ * 
+ * @param arr Pointers to each sorted run.
+ * @param arr The size of each run, at most INT_MAX.
+ * @param size_t The amount of runs, at most UINT32_MAX.
+ * @param arr The output array. Needs room for the sizes of all runs combined.
+ * @param unsigned int The amount of threads to use.
+ */
+void parallelMultiwayMerge(const int* const runs[], const size_t sizes[], const size_t, int out[], const unsigned int);
 
 /**
  * @brief Demonstrates the use of Merge Sort.
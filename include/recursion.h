@@ -5,7 +5,9 @@
 #ifndef RECURSIVE_H
 #define RECURSIVE_H
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 namespace recursion {
 
@@ -27,6 +29,16 @@ int addDigits(int);
  */
 std::string reverseString(std::string);
 
+/**
+ * @brief Reverse a string recursively, allocating the results from a memory resource. ie. Word -> droW.
+ * 
+ * @param std::string_view The string to reverse.
+ * @param std::pmr::memory_resource The resource the results are allocated from.
+ * 
+ * @return The reversed string.
+ */
+std::pmr::string reverseString(std::string_view, std::pmr::memory_resource*);
+
 /**
  * @brief Demonstrates the use of recursive functions.
  */
@@ -0,0 +1,28 @@
+/**
+ * @file runner.h
+ * @brief Header file for the command line runner that runs the demonstrations or timed scenarios.
+ */
+#ifndef RUNNER_H
+#define RUNNER_H
+
+namespace runner {
+
+/**
+ * @brief Parses the command line and runs what it asks for. With no arguments, runs every demonstration in order.
+ * Run with --help to see the options.
+ *
+ * @param int The amount of arguments.
+ * @param arr The arguments, as passed to main.
+ *
+ * @return The exit code for main. 0 on success, 1 if the arguments were invalid.
+ */
+int run(int, char* argv[]);
+
+/**
+ * @brief Runs the demonstration() of every concept, one after the other.
+ */
+void runDemonstrations();
+
+} // namespace runner
+
+#endif
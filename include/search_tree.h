@@ -0,0 +1,138 @@
+/**
+ * @file search_tree.h
+ * @brief Header file for static search indexes over sorted keys (S+-tree and learned index).
+ */
+#ifndef SEARCH_TREE_H
+#define SEARCH_TREE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace search_tree {
+
+constexpr int NODE_KEYS = 16; /**< Keys per tree node. 16 ints fill exactly one 64-byte cache line */
+
+/**
+ * @brief One node of the static tree. Aligned so that a node never straddles two cache lines.
+ */
+struct alignas(64) Node {
+    int keys[NODE_KEYS];
+};
+
+/**
+ * @brief Static, read-only B+-tree (S+-tree) built on top of a sorted std::vector.
+ *
+ * The sorted vector itself is the leaf level. Every tree node stores the largest key of each of
+ * its 16 children, so a lookup touches one cache line per level and finishes with binary search on
+ * a 16-element window of the vector. The vector must outlive the tree and must not be modified.
+ */
+class StaticSearchTree {
+public:
+    /**
+     * @brief Builds the tree over the sorted vector.
+     *
+     * @param std::vector<int> The sorted vector to index.
+     */
+    explicit StaticSearchTree(const std::vector<int>&);
+
+    /**
+     * @brief Looks up a value.
+     *
+     * @param int The value to search for.
+     *
+     * @return The index in the vector where the value was found. If the value wasn't found,
+     * it returns -1.
+     */
+    int find(int) const;
+
+    /**
+     * @brief Gets the memory used by the index, not counting the indexed vector.
+     *
+     * @return The size of the index in bytes.
+     */
+    size_t memoryUsage() const;
+
+private:
+    const std::vector<int>& data; /**< The indexed vector (leaf level) */
+    std::vector<Node> nodes; /**< All levels, stored from the root down */
+    std::vector<size_t> levelOffsets; /**< Index of the first node of each level in nodes, root first */
+};
+
+/**
+ * @brief One linear piece of the learned index. Predicts position = intercept + slope * (key - firstKey).
+ */
+struct Segment {
+    int firstKey;
+    double slope;
+    int intercept;
+};
+
+/**
+ * @brief Piecewise-linear learned index (PGM-style) built on top of a sorted std::vector.
+ *
+ * Each segment predicts the position of a key within a bounded error. A lookup finds the segment,
+ * predicts the position and finishes with binary search on the small window around it. The vector
+ * must outlive the index and must not be modified.
+ */
+class LearnedIndex {
+public:
+    /**
+     * @brief Builds the index over the sorted vector.
+     *
+     * @param std::vector<int> The sorted vector to index.
+     * @param int The maximum error of a predicted position. Larger values mean fewer segments but
+     * larger windows to search.
+     */
+    LearnedIndex(const std::vector<int>&, int);
+
+    /**
+     * @brief Looks up a value.
+     *
+     * @param int The value to search for.
+     *
+     * @return The index in the vector where the value was found. If the value wasn't found,
+     * it returns -1.
+     */
+    int find(int) const;
+
+    /**
+     * @brief Gets the memory used by the index, not counting the indexed vector.
+     *
+     * @return The size of the index in bytes.
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * @brief Gets the amount of linear segments the keys were split into.
+     *
+     * @return The amount of segments.
+     */
+    size_t segmentCount() const;
+
+private:
+    const std::vector<int>& data; /**< The indexed vector */
+    int maxError; /**< The error bound the segments were built with */
+    std::vector<int> segmentKeys; /**< First key of each segment, kept separately so finding the segment stays cache friendly */
+    std::vector<Segment> segments; /**< The linear pieces */
+};
+
+/**
+ * @brief Times lookups with binarySearch, StaticSearchTree and LearnedIndex on the same keys
+ * and logs the average latency and the memory overhead of each index.
+ *
+ * The keys are built with binary_search::generateSortedKeys, so they stay unique and in int range for any amount
+ * up to INT_MAX.
+ *
+ * @param size_t The amount of sorted keys to build, at most INT_MAX.
+ * @param size_t The amount of lookups to time.
+ */
+void compareLookups(size_t, size_t);
+
+/**
+ * @brief Demonstrates the static search indexes.
+ */
+void demonstration();
+
+} // namespace search_tree
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file set_operations.h
+ * @brief Header file for set operations (intersection, union and difference) on sorted arrays.
+ */
+#ifndef SET_OPERATIONS_H
+#define SET_OPERATIONS_H
+
+#include <cstddef>
+
+namespace set_operations {
+
+constexpr size_t GALLOP_RATIO = 32; /**< When one set is this many times larger than the other, galloping search is used instead of merging */
+
+/*
+ * All of the functions below take sets as sorted arrays with no duplicates, and write the result into
+ * an output array supplied by the caller. Nothing is allocated. The output may be the same array as the
+ * first input (but not the second), which lets results be narrowed down in place.
+ */
+
+/**
+ * @brief Intersects two sets. The output needs room for the size of the smaller set.
+ *
+ * @param arr The first set.
+ * @param size_t The size of the first set.
+ * @param arr The second set.
+ * @param size_t The size of the second set.
+ * @param arr The output array.
+ *
+ * @return The amount of values written to the output array.
+ */
+size_t setIntersection(const int a[], const size_t, const int b[], const size_t, int out[]);
+
+/**
+ * @brief Unites two sets. The output needs room for the sizes of both sets combined, and may not be
+ * the same array as either input.
+ *
+ * @param arr The first set.
+ * @param size_t The size of the first set.
+ * @param arr The second set.
+ * @param size_t The size of the second set.
+ * @param arr The output array.
+ *
+ * @return The amount of values written to the output array.
+ */
+size_t setUnion(const int a[], const size_t, const int b[], const size_t, int out[]);
+
+/**
+ * @brief Gets the values of the first set that aren't in the second set. The output needs room for the
+ * size of the first set.
+ *
+ * @param arr The first set.
+ * @param size_t The size of the first set.
+ * @param arr The second set.
+ * @param size_t The size of the second set.
+ * @param arr The output array.
+ *
+ * @return The amount of values written to the output array.
+ */
+size_t setDifference(const int a[], const size_t, const int b[], const size_t, int out[]);
+
+/**
+ * @brief Intersects any amount of sets. The output needs room for the size of the smallest set.
+ *
+ * @param arr Pointers to each set.
+ * @param arr The size of each set.
+ * @param size_t The amount of sets.
+ * @param arr The output array.
+ *
+ * @return The amount of values written to the output array.
+ */
+size_t setIntersectionMany(const int* const sets[], const size_t sizes[], const size_t, int out[]);
+
+/**
+ * @brief Demonstrates the set operations.
+ */
+void demonstration();
+
+} // namespace set_operations
+
+#endif
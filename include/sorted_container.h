@@ -0,0 +1,102 @@
+/**
+ * @file sorted_container.h
+ * @brief Header file for a sorted container that takes inserts without re-sorting everything.
+ */
+#ifndef SORTED_CONTAINER_H
+#define SORTED_CONTAINER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace sorted_container {
+
+constexpr size_t BUFFER_SIZE = 64; /**< Inserts collected before they're sorted into the levels. Also the capacity of the first level */
+
+/**
+ * @brief Log-structured sorted array. Keeps its values in a handful of sorted levels, where each level can hold
+ * twice as much as the one before it, plus a small unsorted write buffer.
+ *
+ * Inserts go into the buffer. When the buffer fills up, it's sorted and merged together with the smaller levels
+ * into the first empty level that fits them. Every value is merged O(log n) times in total, instead of the whole
+ * array being re-sorted for every batch.
+ */
+class LogStructuredArray {
+public:
+    /**
+     * @brief Inserts a value.
+     *
+     * @param int The value to insert.
+     */
+    void insert(int);
+
+    /**
+     * @brief Inserts a batch of values. Large batches are sorted and merged in as one run, skipping the buffer.
+     *
+     * @param std::vector<int> The values to insert, in any order.
+     */
+    void insert(const std::vector<int>&);
+
+    /**
+     * @brief Looks up a value.
+     *
+     * @param int The value to search for.
+     *
+     * @return The index of the first occurrence of the value in the sorted order of all values in the container,
+     * the same as the lower bound of the value in toVector(). If the value wasn't found, it returns -1.
+     */
+    int find(int) const;
+
+    /**
+     * @brief Checks whether a value is in the container. Cheaper than find, since it can stop at the first level
+     * that has the value.
+     *
+     * @param int The value to search for.
+     *
+     * @return True if the value was found.
+     */
+    bool contains(int) const;
+
+    /**
+     * @brief Gets the amount of values in the container.
+     *
+     * @return The amount of values.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets all of the values in sorted order.
+     *
+     * @return A sorted vector of all values.
+     */
+    std::vector<int> toVector() const;
+
+private:
+    /**
+     * @brief Merges a sorted run and all of the levels below the first level it fits in, into that level.
+     *
+     * @param std::vector<int> The sorted run to add.
+     */
+    void addRun(std::vector<int>);
+
+    std::vector<int> buffer; /**< Unsorted recent inserts */
+    std::vector<std::vector<int>> levels; /**< Sorted levels. Level i holds at most BUFFER_SIZE * 2^i values, and may be empty */
+    size_t count = 0; /**< Amount of values in the buffer and levels */
+};
+
+/**
+ * @brief Runs a mixed workload of 90% lookups and 10% inserts on a LogStructuredArray and on a sorted std::vector
+ * that's re-sorted after every batch of inserts, and logs the insert throughput and lookup latency of each.
+ *
+ * @param size_t The amount of values to start with.
+ * @param size_t The amount of operations to run.
+ */
+void mixedWorkload(size_t, size_t);
+
+/**
+ * @brief Demonstrates the log-structured sorted array.
+ */
+void demonstration();
+
+} // namespace sorted_container
+
+#endif
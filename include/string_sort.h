@@ -0,0 +1,81 @@
+/**
+ * @file string_sort.h
+ * @brief Header file for string sorting algorithms (MSD Radix Sort and Multikey Quick Sort).
+ */
+#ifndef STRING_SORT_H
+#define STRING_SORT_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace string_sort {
+
+/**
+ * @brief Stores many strings back to back in one contiguous buffer, so sorting their views reads through one block
+ * of memory instead of following a separate heap pointer for every string.
+ */
+class StringArena {
+public:
+    /**
+     * @brief Copies a string to the end of the arena.
+     *
+     * @param std::string_view The string to add.
+     */
+    void add(std::string_view);
+
+    /**
+     * @brief Gets a view of every string in the arena, in the order they were added. The views stay valid until
+     * the next call to add.
+     *
+     * @return The views.
+     */
+    std::vector<std::string_view> views() const;
+
+    /**
+     * @brief Gets the amount of strings in the arena.
+     *
+     * @return The amount of strings.
+     */
+    size_t size() const;
+
+private:
+    std::string characters; /**< Every string, back to back */
+    std::vector<size_t> ends = { 0 }; /**< End of each string in characters. String i starts at ends[i] */
+};
+
+/**
+ * @brief Sorts strings with MSD (most significant digit) Radix Sort, one character at a time.
+ *
+ * @param arr The strings to sort.
+ * @param size_t The amount of strings.
+ */
+void msdRadixSort(std::string_view strings[], const size_t);
+
+/**
+ * @brief Sorts strings with Multikey Quick Sort (three-way radix quick sort).
+ *
+ * @param arr The strings to sort.
+ * @param size_t The amount of strings.
+ * @param bool When true, the next 8 characters of every string are cached as one number, so the strings are
+ * partitioned 8 characters at a time and each string's characters are only read once per 8 levels.
+ */
+void multikeyQuickSort(std::string_view strings[], const size_t, const bool);
+
+/**
+ * @brief Sorts the same strings with std::sort, MSD Radix Sort and both modes of Multikey Quick Sort, and logs
+ * how long each one took.
+ *
+ * @param size_t The amount of strings to generate.
+ */
+void compareSorts(size_t);
+
+/**
+ * @brief Demonstrates the string sorting algorithms.
+ */
+void demonstration();
+
+} // namespace string_sort
+
+#endif
@@ -5,7 +5,9 @@
 #ifndef UTILITY_H
 #define UTILITY_H
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include "logger/log.h"
 
 namespace utility {
@@ -15,9 +17,10 @@ namespace utility {
      * 
      * Call this before every section.
      * 
-     * @param std::string The name of the section.
+     * @param std::string_view The name of the section.
+     * @param std::pmr::memory_resource The resource the title is built in.
      */
-    void printSectionTitle(const std::string);
+    void printSectionTitle(std::string_view, std::pmr::memory_resource* = std::pmr::get_default_resource());
 
 } // namespace utility
 
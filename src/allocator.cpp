@@ -0,0 +1,204 @@
+/**
+ * @file allocator.cpp
+ * @brief Source file for the memory resources.
+ */
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "allocator.h"
+#include "bit_mask.h"
+#include "merge_sort.h"
+#include "recursion.h"
+#include "logger/log.h"
+#include "utility.h"
+
+namespace allocator {
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstreamResource) : upstream(upstreamResource) {}
+
+size_t CountingResource::allocations() const {
+    return allocationCount;
+}
+
+size_t CountingResource::bytesAllocated() const {
+    return byteCount;
+}
+
+void* CountingResource::do_allocate(const size_t bytes, const size_t alignment) {
+    allocationCount++;
+    byteCount += bytes;
+    return upstream->allocate(bytes, alignment);
+}
+
+void CountingResource::do_deallocate(void* p, const size_t bytes, const size_t alignment) {
+    upstream->deallocate(p, bytes, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+/**
+ * Size classes go up to 64 KiB. Anything larger is passed straight through to the system, since a pool doesn't help
+ * with allocations that big.
+ */
+static std::pmr::pool_options poolOptions() {
+    std::pmr::pool_options options;
+    options.largest_required_pool_block = 64 * 1024;
+    return options;
+}
+
+/**
+ * Every thread gets its own unsynchronized pool the first time it asks, which is destroyed when the thread exits.
+ */
+std::pmr::memory_resource* threadLocalPool() {
+    thread_local std::pmr::unsynchronized_pool_resource pool(poolOptions());
+    return &pool;
+}
+
+/**
+ * Sorts with bottom-up merge sort (merge on runs that double in size), reverses a long string, prints many numbers
+ * in binary and prints a section title. Each is run with plain heap allocations, then with a pool or an arena. The
+ * allocations are counted by a CountingResource that sits between the arena or pool and the system, so the counts
+ * show how many allocations actually reached the system. The arena never frees anything on its own, so it's released after each pass.
+ */
+void demonstration() {
+    utility::printSectionTitle("Arena and Pool Allocators");
+
+    auto elapsedMs = [](const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    auto report = [](const std::string& name, const CountingResource& counter, const double ms) {
+        LOG(name, ": ", counter.allocations(), " system allocations, ", counter.bytesAllocated(), " bytes, ", ms, " ms\n");
+    };
+
+    /*****************
+    Merge
+    *****************/
+    std::mt19937 gen(12345);
+    std::vector<int> unsorted(1 << 18);
+    for (auto& v : unsorted) {
+        v = static_cast<int>(gen());
+    }
+    LOG("Bottom-up merge sort of ", unsorted.size(), " values\n");
+
+    auto sortWith = [&unsorted](std::pmr::memory_resource* resource, std::pmr::monotonic_buffer_resource* arena) {
+        std::vector<int> data = unsorted;
+        const int size = static_cast<int>(data.size());
+        for (int width = 1; width < size; width *= 2) {
+            for (int left = 0; left + width < size; left += 2 * width) {
+                merge_sort::merge(data, left, left + width - 1, std::min(left + 2 * width, size) - 1, resource);
+            }
+            if (arena) {
+                arena->release();
+            }
+        }
+    };
+
+    {
+        CountingResource heap;
+        const auto start = std::chrono::steady_clock::now();
+        sortWith(&heap, nullptr);
+        report("Heap", heap, elapsedMs(start));
+    }
+    {
+        CountingResource upstream;
+        std::pmr::unsynchronized_pool_resource pool(poolOptions(), &upstream);
+        const auto start = std::chrono::steady_clock::now();
+        sortWith(&pool, nullptr);
+        report("Pool", upstream, elapsedMs(start));
+    }
+    {
+        CountingResource upstream;
+        std::pmr::monotonic_buffer_resource arena(&upstream);
+        const auto start = std::chrono::steady_clock::now();
+        sortWith(&arena, &arena);
+        report("Arena", upstream, elapsedMs(start));
+    }
+
+    /*****************
+    Reverse string
+    *****************/
+    constexpr int REVERSE_REPEATS = 20;
+    const std::string text(2000, 'a');
+    LOG("Reversing a ", text.size(), " character string ", REVERSE_REPEATS, " times\n");
+    {
+        const auto start = std::chrono::steady_clock::now();
+        size_t total = 0;
+        for (int i = 0; i < REVERSE_REPEATS; i++) {
+            total += recursion::reverseString(text).size();
+        }
+        LOG("std::string version: ", total, " characters, ", elapsedMs(start), " ms\n");
+    }
+    {
+        CountingResource heap;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < REVERSE_REPEATS; i++) {
+            recursion::reverseString(text, &heap);
+        }
+        report("std::string_view version on the heap", heap, elapsedMs(start));
+    }
+    {
+        CountingResource upstream;
+        std::pmr::monotonic_buffer_resource arena(&upstream);
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < REVERSE_REPEATS; i++) {
+            recursion::reverseString(text, &arena);
+            arena.release();
+        }
+        report("std::string_view version in an arena", upstream, elapsedMs(start));
+    }
+
+    /*****************
+    Binary representation
+    *****************/
+    constexpr int NUMBERS = 100000;
+    LOG("Printing ", NUMBERS, " numbers in decimal and binary\n");
+    {
+        const auto start = std::chrono::steady_clock::now();
+        size_t total = 0;
+        for (int i = 0; i < NUMBERS; i++) {
+            total += bit_mask::printDecimalAndBinaryRepresentation(i).size();
+        }
+        LOG("std::string version: ", total, " characters, ", elapsedMs(start), " ms\n");
+    }
+    {
+        CountingResource upstream;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUMBERS; i++) {
+            char buffer[128]; // Enough for the whole string, so the arena never needs to go to upstream
+            std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), &upstream);
+            bit_mask::printDecimalAndBinaryRepresentation(i, &arena);
+        }
+        report("Reserved std::pmr::string in a stack arena", upstream, elapsedMs(start));
+    }
+
+    /*****************
+    Section title
+    *****************/
+    LOG("Printing a section title\n");
+    {
+        CountingResource heap;
+        const auto start = std::chrono::steady_clock::now();
+        utility::printSectionTitle("Counted On The Heap", &heap);
+        report("Section title on the heap", heap, elapsedMs(start));
+    }
+    {
+        CountingResource upstream;
+        const auto start = std::chrono::steady_clock::now();
+        char buffer[512]; // Enough for the whole title, so the arena never needs to go to upstream
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), &upstream);
+        utility::printSectionTitle("Counted In A Stack Arena", &arena);
+        report("Section title in a stack arena", upstream, elapsedMs(start));
+    }
+
+    /*****************
+    Thread-local pool
+    *****************/
+    const auto start = std::chrono::steady_clock::now();
+    sortWith(threadLocalPool(), nullptr);
+    LOG("Merge sort again using threadLocalPool(): ", elapsedMs(start), " ms\n");
+}
+
+} // namespace allocator
@@ -2,6 +2,11 @@
  * @file binary_search.cpp
  * @brief Implementation file for demonstrating Binary Search.
  */
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <string>
 #include <vector>
 #include <thread>
 #include "binary_search.h"
@@ -18,11 +23,20 @@ namespace binary_search {
  * It will keep searching until it either finds the value or it cannot search anymore.
  */
 int binarySearch(const std::vector<int>& list, int target) {
-    int low = 0;
-    int high = list.size() - 1;
+    return binarySearch(list, target, 0, list.size() - 1);
+}
 
+/**
+ * Same as the version above, but only searches between low and high. This lets indexes that
+ * narrow down the position of the target first (ie. search_tree) finish the search with the
+ * same logic.
+ */
+int binarySearch(const std::vector<int>& list, int target, int low, int high, int* probes) {
     while (low <= high) {
         int mid = low + (high - low) / 2; // Use this instead of high + low / 2 to prevent overflows with large numbers
+        if (probes) {
+            (*probes)++;
+        }
 
         // Target was found
         if (list[mid] == target) {
@@ -41,6 +55,253 @@ int binarySearch(const std::vector<int>& list, int target) {
     return -1; // Target not found
 }
 
+constexpr int INTERPOLATION_CUTOFF = 16; /**< Windows smaller than this are finished with binarySearch, where guessing no longer pays off */
+
+/**
+ * Keeps the closest known value below the target (at left) and above it (at right), and guesses that the
+ * target lies on the straight line between them. Because those values come from earlier probes, each step
+ * only reads one new value.
+ * 
+ * On skewed values the guess can land right next to one end every time, which would take O(n) probes. So
+ * every guess is checked: if it didn't at least halve the window, the next probe is a plain binary search
+ * midpoint. Every two probes then halve the window at least once, which bounds the worst case at about
+ * 2 * log2(n) probes. Small windows are finished with binarySearch.
+ */
+int interpolationSearch(const std::vector<int>& list, int target, int* probes) {
+    const int size = static_cast<int>(list.size());
+    if (size == 0) {
+        return -1;
+    }
+    if (probes) {
+        *probes += (size > 1) ? 2 : 1;
+    }
+    int left = 0;
+    int right = size - 1;
+    int leftValue = list[left];
+    int rightValue = list[right];
+    if (target <= leftValue || target >= rightValue) {
+        return (target == leftValue) ? left : (target == rightValue) ? right : -1;
+    }
+
+    bool binaryStep = false; // Set when the last guess didn't halve the window
+    while (right - left > 1) {
+        if (right - left - 1 < INTERPOLATION_CUTOFF) {
+            return binarySearch(list, target, left + 1, right - 1, probes);
+        }
+
+        int mid;
+        if (binaryStep) {
+            mid = left + (right - left) / 2;
+        }
+        else {
+            // Calculated in double since the differences between values can overflow an int
+            const double fraction = (static_cast<double>(target) - leftValue) / (static_cast<double>(rightValue) - leftValue);
+            mid = left + static_cast<int>(fraction * (right - left));
+            mid = std::min(std::max(mid, left + 1), right - 1);
+        }
+
+        if (probes) {
+            (*probes)++;
+        }
+        const int value = list[mid];
+        if (value == target) {
+            return mid;
+        }
+
+        const int previousWindow = right - left;
+        if (value < target) {
+            left = mid;
+            leftValue = value;
+        }
+        else {
+            right = mid;
+            rightValue = value;
+        }
+        binaryStep = !binaryStep && right - left > previousWindow - (right - left);
+    }
+
+    return -1; // Target not found
+}
+
+/**
+ * Reads indexes 0, 1, 2, 4, 8... until it finds a value that is greater than the target, or runs off the
+ * end of the source. The target must then be between the last two indexes read, which is searched with
+ * binary search. Reads past the end count as greater than the target. If the target is at index i, this
+ * takes about 2 * log2(i) reads no matter how long the source is.
+ */
+int exponentialSearch(const std::function<bool(int, int&)>& at, int target, int* probes) {
+    auto read = [&](const int index, int& value) {
+        if (probes) {
+            (*probes)++;
+        }
+        return at(index, value);
+    };
+
+    int value = 0;
+    if (!read(0, value) || value > target) {
+        return -1;
+    }
+    if (value == target) {
+        return 0;
+    }
+
+    // Find a window (low, high) that must hold the target if it's there. The value at low is less than the target.
+    int low = 0;
+    long long high = 1;
+    while (high <= INT_MAX && read(static_cast<int>(high), value) && value <= target) {
+        if (value == target) {
+            return static_cast<int>(high);
+        }
+        low = static_cast<int>(high);
+        high *= 2;
+    }
+
+    // Binary search the inside of the window. If the doubling stopped at INT_MAX, high was never read, so INT_MAX
+    // itself is still in the window. Indexes are kept in 64 bits so that searchLow can pass INT_MAX.
+    long long searchLow = low + 1;
+    long long searchHigh = (high > INT_MAX) ? INT_MAX : high - 1;
+    while (searchLow <= searchHigh) {
+        long long mid = searchLow + (searchHigh - searchLow) / 2;
+
+        // Past the end of the source, or the target is in the left half
+        if (!read(static_cast<int>(mid), value) || value > target) {
+            searchHigh = mid - 1;
+        }
+        // Target was found
+        else if (value == target) {
+            return static_cast<int>(mid);
+        }
+        // Search in the right half
+        else {
+            searchLow = mid + 1;
+        }
+    }
+
+    return -1; // Target not found
+}
+
+/**
+ * Builds the keys from gaps between consecutive keys, in 64 bits, then scales them down if they don't fit in an
+ * int. Every gap is at least 1, so only the part of each gap above 1 is scaled, which keeps the keys unique.
+ * Zipf gaps are drawn from a precalculated table of the distribution's cumulative weights.
+ */
+std::vector<int> generateSortedKeys(const size_t size, const KeyDistribution distribution, std::mt19937& gen) {
+    std::vector<long long> keys(size);
+    long long key = 0;
+    if (distribution == KeyDistribution::Uniform) {
+        std::uniform_int_distribution<int> gap(1, 16);
+        for (auto& k : keys) {
+            key += gap(gen);
+            k = key;
+        }
+    }
+    else if (distribution == KeyDistribution::Zipfian) {
+        constexpr int MAX_GAP = 1 << 20;
+        constexpr double EXPONENT = 1.2;
+        std::vector<double> weights(MAX_GAP);
+        for (int g = 0; g < MAX_GAP; g++) {
+            weights[g] = 1.0 / std::pow(g + 1.0, EXPONENT);
+        }
+        std::discrete_distribution<int> gap(weights.begin(), weights.end());
+        for (auto& k : keys) {
+            key += gap(gen) + 1;
+            k = key;
+        }
+    }
+    else {
+        constexpr size_t CLUSTERS = 16;
+        constexpr long long CLUSTER_GAP = 100000000;
+        std::uniform_int_distribution<int> gap(1, 4);
+        for (size_t i = 0; i < size; i++) {
+            key += (i > 0 && i % std::max<size_t>(size / CLUSTERS, 1) == 0) ? CLUSTER_GAP : gap(gen);
+            keys[i] = key;
+        }
+    }
+
+    // Key i is i + 1 plus the sum of its gaps above 1. That sum never decreases, so scaling it can't make two keys equal
+    const long long extra = key - static_cast<long long>(size);
+    const double scale = (key > INT_MAX) ? static_cast<double>(INT_MAX - static_cast<long long>(size)) / extra : 1.0;
+    std::vector<int> result(size);
+    for (size_t i = 0; i < size; i++) {
+        const long long minimum = static_cast<long long>(i) + 1;
+        const long long scaled = minimum + static_cast<long long>((keys[i] - minimum) * scale);
+        result[i] = static_cast<int>(std::min<long long>(scaled, INT_MAX));
+    }
+    return result;
+}
+
+/**
+ * Looks up a mix of keys that are in the set and values that fall between keys. Probes are counted in a
+ * separate, untimed pass, so that counting doesn't affect the latency.
+ */
+void compareSearches(const size_t size) {
+    const char* names[] = { "uniform", "Zipfian", "clustered" };
+    const KeyDistribution distributions[] = { KeyDistribution::Uniform, KeyDistribution::Zipfian, KeyDistribution::Clustered };
+
+    for (int d = 0; d < 3; d++) {
+        std::mt19937 gen(12345);
+        const std::vector<int> keys = generateSortedKeys(size, distributions[d], gen);
+        std::uniform_int_distribution<size_t> pick(0, size - 1);
+        std::vector<int> lookups(std::min<size_t>(size, 100000));
+        for (size_t i = 0; i < lookups.size(); i++) {
+            const int k = keys[pick(gen)];
+            lookups[i] = (i % 2 == 0) ? k : k - 1; // Every other lookup is usually missing
+        }
+        auto source = [&keys](const int index, int& value) {
+            if (index >= static_cast<int>(keys.size())) {
+                return false;
+            }
+            value = keys[index];
+            return true;
+        };
+
+        auto compare = [&](const std::string& name, auto&& search) {
+            long long probes = 0;
+            for (const int l : lookups) {
+                int p = 0;
+                search(l, &p);
+                probes += p;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            long long found = 0;
+            for (const int l : lookups) {
+                found += (search(l, nullptr) != -1);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            const double ns = std::chrono::duration<double, std::nano>(end - start).count() / lookups.size();
+            LOG(name, ": ", static_cast<double>(probes) / lookups.size(), " probes and ", ns, " ns per lookup, ", found, " found\n");
+        };
+
+        LOG("Searching ", size, " ", names[d], " keys from ", keys.front(), " to ", keys.back(), "\n");
+        compare("binarySearch", [&](const int t, int* p) { return binarySearch(keys, t, 0, static_cast<int>(keys.size()) - 1, p); });
+        compare("interpolationSearch", [&](const int t, int* p) { return interpolationSearch(keys, t, p); });
+        compare("exponentialSearch", [&](const int t, int* p) { return exponentialSearch(source, t, p); });
+    }
+}
+
+/**
+ * Same halving as binarySearch, but instead of stopping at a match it keeps narrowing until low and high
+ * cross. At that point low is the first index whose value is greater than or equal to the target, which is
+ * also where the target would be inserted. This is what merging and set operations need.
+ */
+int lowerBound(const int arr[], int target, int low, int high) {
+    while (low <= high) {
+        int mid = low + (high - low) / 2; // Use this instead of high + low / 2 to prevent overflows with large numbers
+
+        // Target is to the right of mid
+        if (arr[mid] < target) {
+            low = mid + 1;
+        }
+        // mid could be the answer, keep looking in the left half
+        else {
+            high = mid - 1;
+        }
+    }
+
+    return low;
+}
+
 /**
  * Recursive version. 
  * Base case: When the target is found or it cannot divide the list anymore (low > high)
@@ -105,6 +366,27 @@ void demonstration() {
     LOG("Looking for 55 recursively\n");
     result = binarySearchRecursive(sortedList, 55, 0, sortedList.size() - 1);
     LOG("Result: ", ((result != -1) ? "found" : "not found"), "\n");
+
+    /*****************
+    Interpolation and exponential versions
+    *****************/
+    LOG("Looking for 400 with interpolation search\n");
+    int probes = 0;
+    result = interpolationSearch(sortedList, 400, &probes);
+    LOG("Result: ", ((result != -1) ? "found" : "not found"), " after ", probes, " probes\n");
+
+    LOG("Looking for 400 with exponential search, without using the size of the list\n");
+    probes = 0;
+    result = exponentialSearch([&sortedList](const int index, int& value) {
+        if (index >= static_cast<int>(sortedList.size())) {
+            return false;
+        }
+        value = sortedList[index];
+        return true;
+    }, 400, &probes);
+    LOG("Result: ", ((result != -1) ? "found" : "not found"), " after ", probes, " probes\n");
+
+    compareSearches(1000000);
 }
 
 } // namespace binary_search
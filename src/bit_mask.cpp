@@ -87,6 +87,25 @@ namespace bit_mask {
         return "\tDecimal representation: " + std::to_string(number) + "\n\tBinary representation: " + std::bitset<BIT_SIZE>(number).to_string();
     }
 
+    /**
+     * Reserves the whole string first and appends each piece to it, instead of creating a temporary string for every "+".
+     */
+    std::pmr::string printDecimalAndBinaryRepresentation(const int number, std::pmr::memory_resource* resource) {
+        constexpr char DECIMAL_LABEL[] = "\tDecimal representation: ";
+        constexpr char BINARY_LABEL[] = "\n\tBinary representation: ";
+        const std::string decimal = std::to_string(number); // Fits in the small string buffer, so no allocation
+
+        std::pmr::string output(resource);
+        output.reserve(sizeof(DECIMAL_LABEL) + decimal.size() + sizeof(BINARY_LABEL) + BIT_SIZE);
+        output += DECIMAL_LABEL;
+        output += decimal;
+        output += BINARY_LABEL;
+        for (int bit = BIT_SIZE - 1; bit >= 0; bit--) {
+            output += (number & (1 << bit)) ? '1' : '0';
+        }
+        return output;
+    }
+
     void demonstration() {
         utility::printSectionTitle("Bit Mask");
 
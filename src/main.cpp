@@ -4,25 +4,17 @@
  */
 #include <thread>
 #include "logger/log.h"
-#include "binary_search.h"
-#include "quick_sort.h"
-#include "recursion.h"
-#include "merge_sort.h"
-#include "bit_mask.h"
+#include "runner.h"
 
 LOG_SETUP
 
-int main() {
+int main(int argc, char* argv[]) {
     std::thread logThread = rk::log::startLogThread();
     LOG_VERIFY
     
-    binary_search::demonstration();
-    quick_sort::demonstration();
-    recursion::demonstration();
-    merge_sort::demonstration();
-    bit_mask::demonstration();
+    const int result = runner::run(argc, argv);
     
     rk::log::endLogThread(logThread);
 
-    return 0;
+    return result;
 }
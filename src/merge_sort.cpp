@@ -2,7 +2,14 @@
  * @file merge_sort.cpp
  * @brief Source file for the Merge Sort algorithm.
  */
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <random>
+#include <thread>
 #include "merge_sort.h"
+#include "binary_search.h"
 #include "utility.h"
 
 namespace merge_sort {
@@ -13,7 +20,7 @@ namespace merge_sort {
      * and "merge" them together. Then, it'll do the same process with the resulting sub-vector. It'll keep doing this with
      * increasingly larger sub-vectors, as a result of the merging, until the vector is fully sorted.
      */
-    void mergeSortRecursive(std::vector<int>& data, const int left, const int right) {
+    void mergeSortRecursive(std::vector<int>& data, const int left, const int right, std::pmr::memory_resource* resource) {
         LOG("Entered mergeSortRecursive\n");
         // Recursive case.
         if (left < right) {
@@ -22,10 +29,10 @@ namespace merge_sort {
             const int mid = left + (right - left) / 2; // Calculation is done this way to prevent overflows with large values.
             LOG("mid is ", mid, "\n");
 
-            mergeSortRecursive(data, left, mid); // Left half
-            mergeSortRecursive(data, mid + 1, right); // Right half
+            mergeSortRecursive(data, left, mid, resource); // Left half
+            mergeSortRecursive(data, mid + 1, right, resource); // Right half
 
-            merge(data, left, mid, right);
+            merge(data, left, mid, right, resource);
         }
         // Implicit base case. This "else" block is left here for demonstration purposes. Remove it during normal use.
         else {
@@ -39,15 +46,18 @@ namespace merge_sort {
      * the element in its correct position in the main vector. It does this until one or both sides are exhausted. At the end, if there are any
      * elements remaining, it simply copies them back into the main vector. The result is that the portion of the vector defined by the indices
      * passed in, is sorted.
+     *
+     * The temporary vectors come from the memory resource passed in. With an arena or a pool, the copies still
+     * happen, but they no longer cost two trips to the system allocator per call.
      */
-    void merge(std::vector<int>& data, const int left, const int mid, const int right) {
+    void merge(std::vector<int>& data, const int left, const int mid, const int right, std::pmr::memory_resource* resource) {
         // Calculate sizes of left and right side
         const size_t left_size = mid - left + 1;
         const size_t right_size = right - mid;
 
         // Copy the data from each side into temporary containers
-        std::vector<int> leftData(left_size);
-        std::vector<int> rightData(right_size);
+        std::pmr::vector<int> leftData(left_size, resource);
+        std::pmr::vector<int> rightData(right_size, resource);
         for (size_t i = 0; i < left_size; i++) {
             leftData[i] = data[left + i];
         }
@@ -92,6 +102,156 @@ namespace merge_sort {
         }
     }
 
+    constexpr uint64_t EXHAUSTED = UINT64_MAX; /**< Player of a run with no values left. Larger than every real player, so it never wins */
+
+    /**
+     * Packs a run's current value and the run's index into one unsigned 64-bit number, value in the upper half. The
+     * value is shifted from [INT_MIN, INT_MAX] to [0, UINT32_MAX] first, so comparing two players as plain numbers
+     * compares their values, and the smaller one is found with a single min instead of a branch. The run index has to
+     * fit in the lower 32 bits.
+     */
+    static uint64_t makePlayer(const int value, const size_t run) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(value) ^ 0x80000000u) << 32) | run;
+    }
+
+    /**
+     * A loser tree is a tournament bracket with one leaf per run, where every inner node remembers the player that
+     * LOST the game played there. After the winner's value is written out, only the winner's run has a new value, so
+     * only the games on the path from its leaf to the root are replayed, and each of those is against the loser stored
+     * at that node. That's log2(k) comparisons per value. The players carry their values, so a replay never has to look
+     * up another run, and each game is a min and a max rather than a branch, since who wins is unpredictable.
+     *
+     * The amount of leaves is rounded up to a power of two. The padding leaves are empty runs that never win.
+     */
+    void multiwayMerge(const int* const runs[], const size_t sizes[], const size_t count, int out[]) {
+        size_t leaves = 1;
+        while (leaves < count) {
+            leaves *= 2;
+        }
+
+        // Play the initial tournament from the leaves up, keeping the winner of each game in winners and the loser in tree
+        std::vector<uint64_t> tree(leaves);
+        std::vector<uint64_t> winners(2 * leaves);
+        size_t total = 0;
+        for (size_t leaf = 0; leaf < leaves; leaf++) {
+            const bool hasValues = leaf < count && sizes[leaf] > 0;
+            winners[leaves + leaf] = hasValues ? makePlayer(runs[leaf][0], leaf) : EXHAUSTED;
+            total += (leaf < count) ? sizes[leaf] : 0;
+        }
+        for (size_t node = leaves - 1; node > 0; node--) {
+            winners[node] = std::min(winners[2 * node], winners[2 * node + 1]);
+            tree[node] = std::max(winners[2 * node], winners[2 * node + 1]);
+        }
+        uint64_t winner = winners[(leaves > 1) ? 1 : leaves]; // With a single run, the winner is the only leaf
+
+        std::vector<size_t> position(count, 0); // Read position in each run
+        for (size_t k = 0; k < total; k++) {
+            out[k] = static_cast<int>(static_cast<uint32_t>(winner >> 32) ^ 0x80000000u);
+
+            // Advance the winner's run
+            const size_t run = static_cast<uint32_t>(winner);
+            const size_t next = ++position[run];
+            winner = (next < sizes[run]) ? makePlayer(runs[run][next], run) : EXHAUSTED;
+
+            // Replay the games on the path to the root
+            for (size_t node = (leaves + run) / 2; node > 0; node /= 2) {
+                const uint64_t loser = tree[node];
+                tree[node] = std::max(loser, winner);
+                winner = std::min(loser, winner);
+            }
+        }
+    }
+
+    /**
+     * Multi-sequence selection. Finds how many values to take from the front of each run so that rank values are
+     * taken in total, and every value taken is less than or equal to every value left behind. It binary searches
+     * for the smallest value v that has at least rank values less than or equal to it, takes everything less than
+     * v from every run, then takes the remaining amount from the copies of v in run order.
+     */
+    static std::vector<size_t> splitRuns(const int* const runs[], const size_t sizes[], const size_t count, const size_t rank) {
+        auto countLess = [&](const size_t r, const long long value) -> size_t {
+            if (value > INT_MAX) {
+                return sizes[r];
+            }
+            if (value <= INT_MIN || sizes[r] == 0) {
+                return 0;
+            }
+            return binary_search::lowerBound(runs[r], static_cast<int>(value), 0, static_cast<int>(sizes[r]) - 1);
+        };
+
+        std::vector<size_t> split(count, 0);
+        if (rank == 0) {
+            return split;
+        }
+
+        long long low = INT_MIN;
+        long long high = INT_MAX;
+        while (low < high) {
+            const long long mid = low + (high - low) / 2;
+            size_t atMost = 0; // Values less than or equal to mid
+            for (size_t r = 0; r < count; r++) {
+                atMost += countLess(r, mid + 1);
+            }
+            if (atMost >= rank) {
+                high = mid;
+            }
+            else {
+                low = mid + 1;
+            }
+        }
+
+        size_t taken = 0;
+        for (size_t r = 0; r < count; r++) {
+            split[r] = countLess(r, low);
+            taken += split[r];
+        }
+        for (size_t r = 0; r < count && taken < rank; r++) {
+            const size_t equal = countLess(r, low + 1) - split[r];
+            const size_t take = std::min(equal, rank - taken);
+            split[r] += take;
+            taken += take;
+        }
+        return split;
+    }
+
+    /**
+     * Each thread gets an equal slice of the output. The runs are split at the first and last rank of the slice
+     * with multi-sequence selection, so the pieces of the runs between the two splits are exactly the values that
+     * belong in that slice. Each thread then merges its pieces with multiwayMerge, and no two threads write to the
+     * same part of the output.
+     */
+    void parallelMultiwayMerge(const int* const runs[], const size_t sizes[], const size_t count, int out[], const unsigned int threadCount) {
+        size_t total = 0;
+        for (size_t r = 0; r < count; r++) {
+            total += sizes[r];
+        }
+        const size_t parts = std::max(1u, threadCount);
+        if (parts == 1 || total < parts) {
+            multiwayMerge(runs, sizes, count, out);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t part = 0; part < parts; part++) {
+            threads.emplace_back([=]() {
+                const size_t firstRank = total * part / parts;
+                const std::vector<size_t> begin = splitRuns(runs, sizes, count, firstRank);
+                const std::vector<size_t> end = splitRuns(runs, sizes, count, total * (part + 1) / parts);
+
+                std::vector<const int*> pieces(count);
+                std::vector<size_t> pieceSizes(count);
+                for (size_t r = 0; r < count; r++) {
+                    pieces[r] = runs[r] + begin[r];
+                    pieceSizes[r] = end[r] - begin[r];
+                }
+                multiwayMerge(pieces.data(), pieceSizes.data(), count, out + firstRank);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
     void demonstration() {
         utility::printSectionTitle("Merge Sort");
 
@@ -112,6 +272,46 @@ namespace merge_sort {
         }
         sortedData = sortedData.substr(0, sortedData.size() - 2);
         LOG("Sorted vector size: ", data.size(), ".\nSorted vector contents:", sortedData, "\n");
+
+        // Build many sorted shards and compare merging them pairwise against merging them all at once
+        constexpr size_t SHARDS = 256;
+        constexpr size_t SHARD_SIZE = 4096;
+        std::mt19937 gen(12345);
+        std::uniform_int_distribution<int> dist(0, 1000000000);
+        std::vector<int> shards(SHARDS * SHARD_SIZE);
+        for (auto& v : shards) {
+            v = dist(gen);
+        }
+        std::vector<const int*> runs(SHARDS);
+        std::vector<size_t> runSizes(SHARDS, SHARD_SIZE);
+        for (size_t s = 0; s < SHARDS; s++) {
+            std::sort(shards.begin() + s * SHARD_SIZE, shards.begin() + (s + 1) * SHARD_SIZE);
+            runs[s] = shards.data() + s * SHARD_SIZE;
+        }
+        LOG("Merging ", SHARDS, " sorted shards of ", SHARD_SIZE, " values\n");
+
+        std::vector<int> pairwise = shards;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t width = SHARD_SIZE; width < pairwise.size(); width *= 2) {
+            for (size_t left = 0; left + width < pairwise.size(); left += 2 * width) {
+                merge(pairwise, left, left + width - 1, std::min(left + 2 * width, pairwise.size()) - 1);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        LOG("Pairwise merge: ", std::chrono::duration<double, std::milli>(end - start).count(), " ms\n");
+
+        std::vector<int> multiway(shards.size());
+        start = std::chrono::steady_clock::now();
+        multiwayMerge(runs.data(), runSizes.data(), SHARDS, multiway.data());
+        end = std::chrono::steady_clock::now();
+        LOG("Multiway merge: ", std::chrono::duration<double, std::milli>(end - start).count(), " ms, ", ((multiway == pairwise) ? "same result" : "DIFFERENT result"), "\n");
+
+        const unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> parallel(shards.size());
+        start = std::chrono::steady_clock::now();
+        parallelMultiwayMerge(runs.data(), runSizes.data(), SHARDS, parallel.data(), threadCount);
+        end = std::chrono::steady_clock::now();
+        LOG("Parallel multiway merge on ", threadCount, " threads: ", std::chrono::duration<double, std::milli>(end - start).count(), " ms, ", ((parallel == pairwise) ? "same result" : "DIFFERENT result"), "\n");
     }
 
 } // namespace merge_sort
\ No newline at end of file
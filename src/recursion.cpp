@@ -46,6 +46,26 @@ std::string reverseString(std::string s) {
     return s.substr(SIZE - 1) + reverseString(s.substr(0, SIZE - 1));
 }
 
+/**
+ * Same recursion as the version above, but the input is a std::string_view, so taking the last character and
+ * the rest of the string doesn't copy anything. The only allocation on each level is the result, which is
+ * reserved at its final size up front and comes from the memory resource passed in.
+ */
+std::pmr::string reverseString(const std::string_view s, std::pmr::memory_resource* resource) {
+    const size_t SIZE = s.size();
+    // Base case
+    if (SIZE <= 1) {
+        return std::pmr::string(s, resource);
+    }
+
+    // Recursive case
+    std::pmr::string reversed(resource);
+    reversed.reserve(SIZE);
+    reversed += s.substr(SIZE - 1);
+    reversed += reverseString(s.substr(0, SIZE - 1), resource);
+    return reversed;
+}
+
 /**
  * Demonstrates recursion by calling the recursive functions in this namespace. 
  */
@@ -0,0 +1,669 @@
+/**
+ * @file runner.cpp
+ * @brief Source file for the command line runner.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "runner.h"
+#include "allocator.h"
+#include "binary_search.h"
+#include "bit_mask.h"
+#include "merge_sort.h"
+#include "quick_sort.h"
+#include "recursion.h"
+#include "search_tree.h"
+#include "set_operations.h"
+#include "sorted_container.h"
+#include "string_sort.h"
+#include "logger/log.h"
+
+namespace runner {
+
+/**
+ * @brief One repetition of a scenario. Returns a checksum of its results so the work can't be optimized away.
+ */
+using Repetition = std::function<long long()>;
+
+/**
+ * @brief An algorithm that can be timed. prepare gets the input values, does any setup that shouldn't be timed
+ * (sorting, building an index) and returns the repetition to time.
+ */
+struct Algorithm {
+    const char* name;
+    const char* description;
+    std::function<Repetition(const std::vector<int>&)> prepare;
+};
+
+/**
+ * @brief A way of generating input values.
+ */
+struct Distribution {
+    const char* name;
+    const char* description;
+    std::function<std::vector<int>(size_t, std::mt19937&)> generate;
+};
+
+/**
+ * @brief One algorithm run on one size and distribution of input, and its measured latencies.
+ */
+struct Scenario {
+    const Algorithm* algorithm;
+    size_t size;
+    const Distribution* distribution;
+    std::vector<double> latenciesMs;
+    long long checksum = 0;
+    int cpu = -1; /**< The CPU the scenario ran on, or -1 if the thread wasn't pinned */
+};
+
+/**
+ * @brief The parsed command line.
+ */
+struct Options {
+    bool demo = false;
+    bool list = false;
+    bool help = false;
+    bool pin = true;
+    bool scenarios = false; /**< Whether any option that describes the scenarios was given */
+    std::vector<std::string> algorithms;
+    std::vector<size_t> sizes = { 100000 };
+    std::vector<std::string> distributions = { "uniform" };
+    int repeat = 10;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+/**
+ * Gets the input sorted, since most of the algorithms need it that way.
+ */
+static std::vector<int> sorted(std::vector<int> values) {
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+/**
+ * The recursive quickSort and mergeSortRecursive log every base case for their demonstrations, which would flood the
+ * log here. So the sorts are driven from their building blocks instead: quick_sort::partition with an explicit stack,
+ * and merge_sort::merge bottom-up, with its temporary vectors coming from the thread's pool.
+ */
+static const std::vector<Algorithm>& algorithms() {
+    static const std::vector<Algorithm> list = {
+        { "binary_search", "Looks up every input value in the sorted input with binary_search::binarySearch",
+            [](const std::vector<int>& input) -> Repetition {
+                auto keys = std::make_shared<std::vector<int>>(sorted(input));
+                return [keys, input]() {
+                    long long found = 0;
+                    for (const int v : input) {
+                        found += (binary_search::binarySearch(*keys, v) != -1);
+                    }
+                    return found;
+                };
+            } },
+        { "interpolation_search", "Same lookups as binary_search with binary_search::interpolationSearch",
+            [](const std::vector<int>& input) -> Repetition {
+                auto keys = std::make_shared<std::vector<int>>(sorted(input));
+                return [keys, input]() {
+                    long long found = 0;
+                    for (const int v : input) {
+                        found += (binary_search::interpolationSearch(*keys, v) != -1);
+                    }
+                    return found;
+                };
+            } },
+        { "exponential_search", "Same lookups as binary_search with binary_search::exponentialSearch, reading the keys as a source of unknown length",
+            [](const std::vector<int>& input) -> Repetition {
+                auto keys = std::make_shared<std::vector<int>>(sorted(input));
+                return [keys, input]() {
+                    auto source = [&keys](const int index, int& value) {
+                        if (index >= static_cast<int>(keys->size())) {
+                            return false;
+                        }
+                        value = (*keys)[index];
+                        return true;
+                    };
+                    long long found = 0;
+                    for (const int v : input) {
+                        found += (binary_search::exponentialSearch(source, v) != -1);
+                    }
+                    return found;
+                };
+            } },
+        { "search_tree", "Same lookups as binary_search with search_tree::StaticSearchTree",
+            [](const std::vector<int>& input) -> Repetition {
+                auto keys = std::make_shared<std::vector<int>>(sorted(input));
+                auto tree = std::make_shared<search_tree::StaticSearchTree>(*keys);
+                return [keys, tree, input]() {
+                    long long found = 0;
+                    for (const int v : input) {
+                        found += (tree->find(v) != -1);
+                    }
+                    return found;
+                };
+            } },
+        { "learned_index", "Same lookups as binary_search with search_tree::LearnedIndex",
+            [](const std::vector<int>& input) -> Repetition {
+                auto keys = std::make_shared<std::vector<int>>(sorted(input));
+                auto index = std::make_shared<search_tree::LearnedIndex>(*keys, 32);
+                return [keys, index, input]() {
+                    long long found = 0;
+                    for (const int v : input) {
+                        found += (index->find(v) != -1);
+                    }
+                    return found;
+                };
+            } },
+        { "quick_sort", "Sorts a copy of the input with quick_sort::partition",
+            [](const std::vector<int>& input) -> Repetition {
+                return [input]() {
+                    std::vector<int> data = input;
+                    std::mt19937 gen(12345);
+                    std::vector<std::pair<int, int>> ranges = { { 0, static_cast<int>(data.size()) - 1 } };
+                    while (!ranges.empty()) {
+                        const auto [low, high] = ranges.back();
+                        ranges.pop_back();
+                        if (low < high) {
+                            const int pivotIndex = quick_sort::partition(data.data(), low, high, gen);
+                            ranges.push_back({ low, pivotIndex - 1 });
+                            ranges.push_back({ pivotIndex + 1, high });
+                        }
+                    }
+                    return data.empty() ? 0LL : static_cast<long long>(data.front()) + data.back();
+                };
+            } },
+        { "merge_sort", "Sorts a copy of the input with merge_sort::merge, bottom-up",
+            [](const std::vector<int>& input) -> Repetition {
+                return [input]() {
+                    std::vector<int> data = input;
+                    const int size = static_cast<int>(data.size());
+                    for (int width = 1; width < size; width *= 2) {
+                        for (int left = 0; left + width < size; left += 2 * width) {
+                            merge_sort::merge(data, left, left + width - 1, std::min(left + 2 * width, size) - 1, allocator::threadLocalPool());
+                        }
+                    }
+                    return data.empty() ? 0LL : static_cast<long long>(data.front()) + data.back();
+                };
+            } },
+        { "multiway_merge", "Merges 64 sorted slices of the input with merge_sort::multiwayMerge",
+            [](const std::vector<int>& input) -> Repetition {
+                constexpr size_t RUNS = 64;
+                auto data = std::make_shared<std::vector<int>>(input);
+                auto runs = std::make_shared<std::vector<const int*>>();
+                auto sizes = std::make_shared<std::vector<size_t>>();
+                for (size_t r = 0; r < RUNS; r++) {
+                    const size_t begin = data->size() * r / RUNS;
+                    const size_t end = data->size() * (r + 1) / RUNS;
+                    std::sort(data->begin() + begin, data->begin() + end);
+                    runs->push_back(data->data() + begin);
+                    sizes->push_back(end - begin);
+                }
+                return [data, runs, sizes]() {
+                    std::vector<int> out(data->size());
+                    merge_sort::multiwayMerge(runs->data(), sizes->data(), runs->size(), out.data());
+                    return out.empty() ? 0LL : static_cast<long long>(out.front()) + out.back();
+                };
+            } },
+        { "set_intersection", "Intersects the unique values of the two halves of the input with set_operations::setIntersection",
+            [](const std::vector<int>& input) -> Repetition {
+                auto a = std::make_shared<std::vector<int>>(sorted(std::vector<int>(input.begin(), input.begin() + input.size() / 2)));
+                auto b = std::make_shared<std::vector<int>>(sorted(std::vector<int>(input.begin() + input.size() / 2, input.end())));
+                a->erase(std::unique(a->begin(), a->end()), a->end());
+                b->erase(std::unique(b->begin(), b->end()), b->end());
+                return [a, b]() {
+                    std::vector<int> out(std::min(a->size(), b->size()));
+                    return static_cast<long long>(set_operations::setIntersection(a->data(), a->size(), b->data(), b->size(), out.data()));
+                };
+            } },
+        { "sorted_container", "Inserts the input into a sorted_container::LogStructuredArray, with a lookup after every insert",
+            [](const std::vector<int>& input) -> Repetition {
+                return [input]() {
+                    sorted_container::LogStructuredArray container;
+                    long long found = 0;
+                    for (const int v : input) {
+                        container.insert(v);
+                        found += container.contains(v / 2);
+                    }
+                    return found;
+                };
+            } },
+        { "recursion", "Adds the digits of every input value with recursion::addDigits",
+            [](const std::vector<int>& input) -> Repetition {
+                return [input]() {
+                    long long sum = 0;
+                    for (const int v : input) {
+                        sum += recursion::addDigits(v & INT_MAX);
+                    }
+                    return sum;
+                };
+            } },
+        { "bit_mask", "Sets, clears, toggles and checks bits on every input value with bit_mask",
+            [](const std::vector<int>& input) -> Repetition {
+                return [input]() {
+                    long long sum = 0;
+                    for (const int v : input) {
+                        sum += bit_mask::checkBits(bit_mask::toggleBits(bit_mask::clearBits(bit_mask::setBits(v, 0b0110), 0b0100), 0b0110), 0b0100);
+                    }
+                    return sum;
+                };
+            } },
+    };
+    return list;
+}
+
+static const std::vector<Distribution>& distributions() {
+    static const std::vector<Distribution> list = {
+        { "uniform", "Uniformly random values from 0 to INT_MAX",
+            [](const size_t size, std::mt19937& gen) {
+                std::uniform_int_distribution<int> dist(0, INT_MAX);
+                std::vector<int> values(size);
+                for (auto& v : values) {
+                    v = dist(gen);
+                }
+                return values;
+            } },
+        { "sorted", "Uniform values, already sorted",
+            [](const size_t size, std::mt19937& gen) {
+                return sorted(distributions()[0].generate(size, gen));
+            } },
+        { "reversed", "Uniform values, sorted in descending order",
+            [](const size_t size, std::mt19937& gen) {
+                std::vector<int> values = sorted(distributions()[0].generate(size, gen));
+                std::reverse(values.begin(), values.end());
+                return values;
+            } },
+        { "zipfian", "Keys whose gaps follow a Zipf distribution (see binary_search::KeyDistribution), in random order",
+            [](const size_t size, std::mt19937& gen) {
+                std::vector<int> values = binary_search::generateSortedKeys(size, binary_search::KeyDistribution::Zipfian, gen);
+                std::shuffle(values.begin(), values.end(), gen);
+                return values;
+            } },
+        { "clustered", "Dense clusters of keys separated by huge gaps (see binary_search::KeyDistribution), in random order",
+            [](const size_t size, std::mt19937& gen) {
+                std::vector<int> values = binary_search::generateSortedKeys(size, binary_search::KeyDistribution::Clustered, gen);
+                std::shuffle(values.begin(), values.end(), gen);
+                return values;
+            } },
+        { "few_unique", "Random values from 0 to 15. Note that quick_sort's partition is quadratic on repeated values",
+            [](const size_t size, std::mt19937& gen) {
+                std::uniform_int_distribution<int> dist(0, 15);
+                std::vector<int> values(size);
+                for (auto& v : values) {
+                    v = dist(gen);
+                }
+                return values;
+            } },
+    };
+    return list;
+}
+
+/**
+ * Orders the CPUs so that consecutive threads land on different NUMA nodes, by taking one CPU from each node in turn.
+ * On Linux the nodes are read from sysfs; anywhere else, or if sysfs has no nodes, the CPUs are used in order. CPUs
+ * outside the process's affinity mask (ie. from taskset or a container's cpuset) are left out, since threads can't be
+ * pinned to them.
+ */
+static std::vector<int> cpuOrder() {
+    // Every CPU the process may run on, in order
+    std::vector<int> allowed;
+    std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    const bool haveMask = sched_getaffinity(0, sizeof(mask), &mask) == 0;
+    if (haveMask) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) {
+                allowed.push_back(cpu);
+            }
+        }
+    }
+
+    for (int node = 0;; node++) {
+        const std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+        FILE* file = std::fopen(path.c_str(), "r");
+        if (!file) {
+            break;
+        }
+        char line[4096] = { 0 };
+        const bool read = std::fgets(line, sizeof(line), file) != nullptr;
+        std::fclose(file);
+
+        // The list looks like "0-3,8-11"
+        std::vector<int> cpus;
+        std::stringstream ranges(read ? line : "");
+        std::string range;
+        while (std::getline(ranges, range, ',')) {
+            int first = 0;
+            int last = 0;
+            const int matched = std::sscanf(range.c_str(), "%d-%d", &first, &last);
+            if (matched >= 1) {
+                for (int cpu = first; cpu <= ((matched == 2) ? last : first); cpu++) {
+                    if (!haveMask || std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+                        cpus.push_back(cpu);
+                    }
+                }
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(cpus);
+        }
+    }
+#endif
+
+    if (nodes.empty()) {
+        if (allowed.empty()) {
+            for (unsigned int cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++) {
+                allowed.push_back(static_cast<int>(cpu));
+            }
+        }
+        return allowed;
+    }
+    std::vector<int> order;
+    for (size_t i = 0;; i++) {
+        bool added = false;
+        for (const auto& node : nodes) {
+            if (i < node.size()) {
+                order.push_back(node[i]);
+                added = true;
+            }
+        }
+        if (!added) {
+            return order;
+        }
+    }
+}
+
+/**
+ * Pins the calling thread to one CPU. Only supported on Linux.
+ *
+ * @return True if the thread was pinned.
+ */
+static bool pinThread(const int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+/**
+ * Splits "a,b,c" into its parts.
+ */
+static std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> parts;
+    std::stringstream stream(list);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+/**
+ * Parses a whole string as a positive number.
+ *
+ * @return False if the string isn't a positive number, or is too large for size_t.
+ */
+static bool parsePositive(const std::string& text, size_t& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    try {
+        value = std::stoull(text);
+    }
+    catch (const std::out_of_range&) {
+        return false;
+    }
+    return value > 0;
+}
+
+/**
+ * Options that take a value take it as the next argument, ie. "--sizes 1000,1000000". Lists are comma separated.
+ *
+ * @return False, after logging why, if the arguments were invalid.
+ */
+static bool parseArguments(const int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--demo") {
+            options.demo = true;
+            continue;
+        }
+        if (arg == "--list") {
+            options.list = true;
+            continue;
+        }
+        if (arg == "--help") {
+            options.help = true;
+            continue;
+        }
+        if (arg == "--no-pin") {
+            options.pin = false;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            LOG("Unknown option, or missing value for: ", arg, "\n");
+            return false;
+        }
+        const std::string value = argv[++i];
+        size_t number = 0;
+        options.scenarios = true;
+        if (arg == "--algorithms") {
+            options.algorithms = splitList(value);
+        }
+        else if (arg == "--distributions") {
+            options.distributions = splitList(value);
+        }
+        else if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const auto& size : splitList(value)) {
+                if (!parsePositive(size, number) || number > INT_MAX) {
+                    LOG("Invalid size: ", size, "\n");
+                    return false;
+                }
+                options.sizes.push_back(number);
+            }
+        }
+        else if (arg == "--repeat" && parsePositive(value, number) && number <= INT_MAX) {
+            options.repeat = static_cast<int>(number);
+        }
+        else if (arg == "--threads" && parsePositive(value, number) && number <= 1024) {
+            options.threads = static_cast<unsigned int>(number);
+        }
+        else {
+            LOG("Unknown option or invalid value: ", arg, " ", value, "\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+static void printHelp() {
+    LOG("Usage: Programming_Concepts_cpp [options]\n"
+        "With no options, runs the demonstration of every concept.\n"
+        "  --demo                  Run the demonstrations (before any scenarios)\n"
+        "  --list                  List the algorithms and distributions\n"
+        "  --algorithms a,b,...    Algorithms to time (default: all)\n"
+        "  --sizes n,m,...         Input sizes (default: 100000)\n"
+        "  --distributions a,b,... Input distributions (default: uniform)\n"
+        "  --repeat n              Timed repetitions per scenario (default: 10)\n"
+        "  --threads n             Scenarios run at the same time (default: hardware threads)\n"
+        "  --no-pin                Don't pin the threads to CPUs\n"
+        "Every combination of algorithm, size and distribution is one scenario. Scenarios only run when at least one\n"
+        "of --algorithms, --sizes, --distributions, --repeat or --threads is given.\n");
+}
+
+static void printList() {
+    LOG("Algorithms:\n");
+    for (const auto& algorithm : algorithms()) {
+        LOG("  ", algorithm.name, ": ", algorithm.description, "\n");
+    }
+    LOG("Distributions:\n");
+    for (const auto& distribution : distributions()) {
+        LOG("  ", distribution.name, ": ", distribution.description, "\n");
+    }
+}
+
+/**
+ * Generates the input on the thread that runs the scenario, so on a NUMA machine the memory is placed on that
+ * thread's node (first touch). The untimed setup is followed by one untimed warm-up repetition.
+ */
+static void runScenario(Scenario& scenario, const int repeat, const unsigned int seed) {
+    std::mt19937 gen(seed);
+    const std::vector<int> input = scenario.distribution->generate(scenario.size, gen);
+    const Repetition repetition = scenario.algorithm->prepare(input);
+
+    scenario.checksum = repetition();
+    for (int r = 0; r < repeat; r++) {
+        const auto start = std::chrono::steady_clock::now();
+        scenario.checksum += repetition();
+        const auto end = std::chrono::steady_clock::now();
+        scenario.latenciesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+}
+
+/**
+ * Gets the value below which the given fraction of the sorted latencies fall (nearest rank).
+ */
+static double percentile(const std::vector<double>& sortedLatencies, const double fraction) {
+    const size_t rank = static_cast<size_t>(fraction * sortedLatencies.size() + 0.999999);
+    return sortedLatencies[std::min(std::max<size_t>(rank, 1), sortedLatencies.size()) - 1];
+}
+
+/**
+ * Looks up each name in a list of algorithms or distributions.
+ *
+ * @return False, after logging the name, if a name wasn't found.
+ */
+template <typename T>
+static bool findAll(const std::vector<std::string>& names, const std::vector<T>& all, std::vector<const T*>& found) {
+    for (const auto& name : names) {
+        const auto it = std::find_if(all.begin(), all.end(), [&name](const T& t) { return name == t.name; });
+        if (it == all.end()) {
+            LOG("Unknown name: ", name, ". Run with --list to see the choices.\n");
+            return false;
+        }
+        found.push_back(&*it);
+    }
+    return true;
+}
+
+/**
+ * Builds every combination of the selected algorithms, sizes and distributions. The worker threads are pinned
+ * to CPUs spread across the NUMA nodes, and each takes the next scenario that hasn't started until there are none
+ * left, so a slow scenario doesn't hold up the others. Once they're all done, the latency distribution of each
+ * scenario is logged from the main thread, in the order the scenarios were listed.
+ */
+static int runScenarios(const Options& options) {
+    std::vector<const Algorithm*> selectedAlgorithms;
+    std::vector<const Distribution*> selectedDistributions;
+    if (options.algorithms.empty()) {
+        for (const auto& algorithm : algorithms()) {
+            selectedAlgorithms.push_back(&algorithm);
+        }
+    }
+    else if (!findAll(options.algorithms, algorithms(), selectedAlgorithms)) {
+        return 1;
+    }
+    if (!findAll(options.distributions, distributions(), selectedDistributions)) {
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios;
+    for (const auto* algorithm : selectedAlgorithms) {
+        for (const size_t size : options.sizes) {
+            for (const auto* distribution : selectedDistributions) {
+                scenarios.push_back({ algorithm, size, distribution, {} });
+            }
+        }
+    }
+
+    const unsigned int threadCount = static_cast<unsigned int>(std::min<size_t>(options.threads, scenarios.size()));
+    const std::vector<int> cpus = cpuOrder();
+    LOG("Running ", scenarios.size(), " scenarios, ", options.repeat, " repetitions each, on ", threadCount, " threads\n");
+
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&, t]() {
+            const int cpu = cpus[t % cpus.size()];
+            const bool pinned = options.pin && pinThread(cpu);
+            for (size_t s = next++; s < scenarios.size(); s = next++) {
+                scenarios[s].cpu = pinned ? cpu : -1;
+                runScenario(scenarios[s], options.repeat, static_cast<unsigned int>(12345 + s));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    LOG("algorithm, size, distribution, cpu, min ms, p50 ms, p90 ms, p99 ms, max ms, mean ms, checksum\n");
+    for (auto& scenario : scenarios) {
+        std::vector<double>& latencies = scenario.latenciesMs;
+        std::sort(latencies.begin(), latencies.end());
+        double mean = 0;
+        for (const double l : latencies) {
+            mean += l / latencies.size();
+        }
+        LOG(scenario.algorithm->name, ", ", scenario.size, ", ", scenario.distribution->name, ", ", scenario.cpu, ", ",
+            latencies.front(), ", ", percentile(latencies, 0.5), ", ", percentile(latencies, 0.9), ", ", percentile(latencies, 0.99), ", ",
+            latencies.back(), ", ", mean, ", ", scenario.checksum, "\n");
+    }
+    return 0;
+}
+
+int run(const int argc, char* argv[]) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printHelp();
+        return 1;
+    }
+    if (options.help) {
+        printHelp();
+        return 0;
+    }
+    if (options.list) {
+        printList();
+        return 0;
+    }
+
+    if (options.demo || !options.scenarios) {
+        runDemonstrations();
+    }
+    return options.scenarios ? runScenarios(options) : 0;
+}
+
+void runDemonstrations() {
+    binary_search::demonstration();
+    quick_sort::demonstration();
+    recursion::demonstration();
+    merge_sort::demonstration();
+    bit_mask::demonstration();
+    search_tree::demonstration();
+    set_operations::demonstration();
+    sorted_container::demonstration();
+    string_sort::demonstration();
+    allocator::demonstration();
+}
+
+} // namespace runner
@@ -0,0 +1,234 @@
+/**
+ * @file search_tree.cpp
+ * @brief Source file for the static search indexes (S+-tree and learned index).
+ */
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SEARCH_TREE_SSE2
+#endif
+#include "search_tree.h"
+#include "binary_search.h"
+#include "logger/log.h"
+#include "utility.h"
+
+namespace search_tree {
+
+/**
+ * Counts how many keys in the node are less than the target, which is also the index of the child
+ * to descend into. With SSE2, all 16 keys are compared in four instructions, packed down to one
+ * byte per key and turned into a 16-bit mask, so there are no branches that depend on the data.
+ */
+static int countLess(const Node& node, const int target) {
+#ifdef SEARCH_TREE_SSE2
+    const __m128i t = _mm_set1_epi32(target);
+    const __m128i* keys = reinterpret_cast<const __m128i*>(node.keys);
+    const __m128i c0 = _mm_cmpgt_epi32(t, _mm_load_si128(keys));
+    const __m128i c1 = _mm_cmpgt_epi32(t, _mm_load_si128(keys + 1));
+    const __m128i c2 = _mm_cmpgt_epi32(t, _mm_load_si128(keys + 2));
+    const __m128i c3 = _mm_cmpgt_epi32(t, _mm_load_si128(keys + 3));
+    const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(c0, c1), _mm_packs_epi32(c2, c3));
+    return static_cast<int>(std::bitset<NODE_KEYS>(_mm_movemask_epi8(packed)).count());
+#else
+    int count = 0;
+    for (int i = 0; i < NODE_KEYS; i++) {
+        count += (node.keys[i] < target);
+    }
+    return count;
+#endif
+}
+
+/**
+ * Splits the vector into blocks of 16 keys (the leaf level) and remembers the largest key of each block.
+ * The next level up gets one key per block, 16 to a node, padded with INT_MAX. This repeats until a level
+ * fits in a single node, which becomes the root. A vector of 16 keys or less doesn't need any nodes.
+ */
+StaticSearchTree::StaticSearchTree(const std::vector<int>& sortedData) : data(sortedData) {
+    const size_t size = data.size();
+    std::vector<int> childMax; // Largest key of each child of the level being built
+    for (size_t block = 0; block * NODE_KEYS < size; block++) {
+        childMax.push_back(data[std::min(block * NODE_KEYS + NODE_KEYS - 1, size - 1)]);
+    }
+
+    std::vector<std::vector<Node>> levels; // Built from the bottom up
+    while (childMax.size() > 1) {
+        const size_t childCount = childMax.size();
+        std::vector<Node> level((childCount + NODE_KEYS - 1) / NODE_KEYS);
+        std::vector<int> nodeMax(level.size());
+        for (size_t n = 0; n < level.size(); n++) {
+            for (size_t k = 0; k < NODE_KEYS; k++) {
+                const size_t child = n * NODE_KEYS + k;
+                level[n].keys[k] = (child < childCount) ? childMax[child] : INT_MAX;
+            }
+            nodeMax[n] = childMax[std::min(n * NODE_KEYS + NODE_KEYS - 1, childCount - 1)];
+        }
+        levels.push_back(std::move(level));
+        childMax = std::move(nodeMax);
+    }
+
+    // Store the levels root first, so a lookup walks forward through memory
+    for (auto it = levels.rbegin(); it != levels.rend(); ++it) {
+        levelOffsets.push_back(nodes.size());
+        nodes.insert(nodes.end(), it->begin(), it->end());
+    }
+}
+
+/**
+ * Values larger than the last key are rejected right away. Every other value descends from the root into
+ * the first child whose largest key is greater than or equal to it. The child found at the bottom level is
+ * a 16-key block of the vector, which is finished with binary search.
+ */
+int StaticSearchTree::find(const int target) const {
+    if (data.empty() || target > data.back()) {
+        return -1;
+    }
+
+    size_t index = 0; // Node index within the current level, and the leaf block at the end
+    for (size_t level = 0; level < levelOffsets.size(); level++) {
+        index = index * NODE_KEYS + countLess(nodes[levelOffsets[level] + index], target);
+    }
+
+    const int low = static_cast<int>(index * NODE_KEYS);
+    const int high = static_cast<int>(std::min(index * NODE_KEYS + NODE_KEYS - 1, data.size() - 1));
+    return binary_search::binarySearch(data, target, low, high);
+}
+
+size_t StaticSearchTree::memoryUsage() const {
+    return nodes.size() * sizeof(Node) + levelOffsets.size() * sizeof(size_t);
+}
+
+/**
+ * Builds the segments greedily. A segment starts at a key and keeps the range of slopes that predict every
+ * key added so far within maxError of its real position (the "shrinking cone"). Each new key narrows the
+ * range, and once the range would be empty the segment is closed and the key starts the next one. The
+ * slope in the middle of the final range is used. Duplicate keys can't be told apart by slope, so a run of
+ * them only stays in a segment while it is within maxError of the segment's start.
+ */
+LearnedIndex::LearnedIndex(const std::vector<int>& sortedData, const int error)
+    : data(sortedData), maxError(std::max(error, 0)) {
+    const size_t size = data.size();
+    size_t start = 0;
+    while (start < size) {
+        double minSlope = 0.0;
+        double maxSlope = std::numeric_limits<double>::infinity();
+        size_t end = start + 1;
+        for (; end < size; end++) {
+            const double dx = static_cast<double>(data[end]) - static_cast<double>(data[start]);
+            const double dy = static_cast<double>(end - start);
+            if (dx == 0.0) {
+                if (dy > maxError) {
+                    break;
+                }
+                continue;
+            }
+            const double newMin = std::max(minSlope, (dy - maxError) / dx);
+            const double newMax = std::min(maxSlope, (dy + maxError) / dx);
+            if (newMin > newMax) {
+                break;
+            }
+            minSlope = newMin;
+            maxSlope = newMax;
+        }
+
+        const double slope = std::isinf(maxSlope) ? 0.0 : (minSlope + maxSlope) / 2;
+        segmentKeys.push_back(data[start]);
+        segments.push_back({ data[start], slope, static_cast<int>(start) });
+        start = end;
+    }
+}
+
+/**
+ * Finds the last segment starting at or before the target, predicts the position and searches the window
+ * of maxError positions around it with binary search. The window is widened by one position on each side to
+ * absorb floating point rounding, and clamped to the positions the segment covers.
+ */
+int LearnedIndex::find(const int target) const {
+    if (segments.empty() || target < segmentKeys.front()) {
+        return -1;
+    }
+
+    const size_t s = std::upper_bound(segmentKeys.begin(), segmentKeys.end(), target) - segmentKeys.begin() - 1;
+    const Segment& segment = segments[s];
+    const int segmentEnd = (s + 1 < segments.size()) ? segments[s + 1].intercept - 1 : static_cast<int>(data.size()) - 1;
+
+    double predicted = segment.intercept + segment.slope * (static_cast<double>(target) - segment.firstKey);
+    predicted = std::min(predicted, static_cast<double>(segmentEnd));
+    const int low = std::max(static_cast<int>(predicted) - maxError - 1, segment.intercept);
+    const int high = std::min(static_cast<int>(predicted) + maxError + 1, segmentEnd);
+    return binary_search::binarySearch(data, target, low, high);
+}
+
+size_t LearnedIndex::memoryUsage() const {
+    return segmentKeys.size() * sizeof(int) + segments.size() * sizeof(Segment);
+}
+
+size_t LearnedIndex::segmentCount() const {
+    return segments.size();
+}
+
+/**
+ * Builds sorted, distinct keys with random gaps, then looks up the same random mix of present and missing
+ * keys with each method. The results are summed and compared so the lookups can't be optimized away and so
+ * that a wrong answer from an index shows up in the log.
+ */
+void compareLookups(const size_t numKeys, const size_t numLookups) {
+    std::mt19937 gen(12345);
+    const std::vector<int> keys = binary_search::generateSortedKeys(numKeys, binary_search::KeyDistribution::Uniform, gen);
+
+    std::uniform_int_distribution<int> pick(0, keys.empty() ? 0 : keys.back());
+    std::vector<int> lookups(numLookups);
+    for (auto& l : lookups) {
+        l = pick(gen);
+    }
+
+    const StaticSearchTree tree(keys);
+    const LearnedIndex learned(keys, 32);
+
+    auto timeLookups = [&](const std::string& name, auto&& find, const size_t memory) {
+        const auto start = std::chrono::steady_clock::now();
+        long long found = 0;
+        for (const int l : lookups) {
+            found += (find(l) != -1);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count() / std::max<size_t>(numLookups, 1);
+        LOG(name, ": ", ns, " ns per lookup, ", found, " found, index memory: ", memory, " bytes\n");
+    };
+
+    LOG("Comparing lookups on ", numKeys, " keys with ", numLookups, " lookups\n");
+    timeLookups("binarySearch", [&](int t) { return binary_search::binarySearch(keys, t); }, 0);
+    timeLookups("StaticSearchTree", [&](int t) { return tree.find(t); }, tree.memoryUsage());
+    timeLookups("LearnedIndex (" + std::to_string(learned.segmentCount()) + " segments)", [&](int t) { return learned.find(t); }, learned.memoryUsage());
+}
+
+/**
+ * Looks up a few values in a small sorted list with both indexes, then compares them against plain binary
+ * search on a larger list.
+ */
+void demonstration() {
+    utility::printSectionTitle("Static Search Tree and Learned Index");
+
+    std::vector<int> sortedList;
+    for (int i = 0; i < 100; i++) {
+        sortedList.push_back(i * i);
+    }
+    const StaticSearchTree tree(sortedList);
+    const LearnedIndex learned(sortedList, 4);
+    LOG("Built a tree using ", tree.memoryUsage(), " bytes and a learned index with ", learned.segmentCount(), " segments over the squares from 0 to 9801\n");
+
+    for (const int target : { 0, 2025, 2026, 9801 }) {
+        LOG("Looking for ", target, "\n");
+        LOG("Tree result: ", tree.find(target), ", learned index result: ", learned.find(target), "\n");
+    }
+
+    compareLookups(1000000, 1000000);
+}
+
+} // namespace search_tree
@@ -0,0 +1,388 @@
+/**
+ * @file set_operations.cpp
+ * @brief Source file for set operations on sorted arrays.
+ */
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SET_OPERATIONS_SSE2
+#endif
+#include "set_operations.h"
+#include "binary_search.h"
+#include "logger/log.h"
+#include "utility.h"
+
+namespace set_operations {
+
+/**
+ * Checks whether one set is so much larger than the other that galloping through the large set beats
+ * walking through both of them.
+ */
+static bool isSkewed(const size_t aSize, const size_t bSize) {
+    return aSize / GALLOP_RATIO > bSize || bSize / GALLOP_RATIO > aSize;
+}
+
+/**
+ * Exponential (galloping) search. Starting at start, probes 1, 2, 4, 8... positions ahead until it passes
+ * the target, then finishes with binary search between the last two probes. Finding a value d positions
+ * away costs about 2 * log2(d) comparisons, so walking through a large set in small jumps stays cheap.
+ *
+ * Returns the first index at or after start whose value is not less than the target, or size if there is none.
+ */
+static size_t gallop(const int arr[], const size_t size, const size_t start, const int target) {
+    if (start >= size || arr[start] >= target) {
+        return start;
+    }
+
+    size_t previous = start; // Last probe known to be less than the target
+    size_t step = 1;
+    while (start + step < size && arr[start + step] < target) {
+        previous = start + step;
+        step *= 2;
+    }
+
+    // Binary search between the last two probes. Done here in size_t rather than with binary_search::lowerBound,
+    // which takes int indexes, so that sets larger than INT_MAX work too.
+    size_t low = previous + 1;
+    size_t high = std::min(start + step, size - 1) + 1; // One past the last candidate
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (arr[mid] < target) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * Scalar merge that only keeps values found in both sets. Used for the leftovers of the SIMD version.
+ */
+static size_t intersectMerge(const int a[], size_t i, const size_t aSize, const int b[], size_t j, const size_t bSize, int out[], size_t k) {
+    while (i < aSize && j < bSize) {
+        const int x = a[i];
+        const int y = b[j];
+        if (x == y) {
+            out[k++] = x;
+        }
+        i += (x <= y);
+        j += (y <= x);
+    }
+    return k;
+}
+
+/**
+ * Block-compare merge. Loads 4 values of each set and compares every value of a against every value of b
+ * by comparing against the 4 rotations of b's block. The matching values of a are written out, then the
+ * block with the smaller last value is advanced (both if they're equal). Once either set has less than
+ * 4 values left, the rest is finished with a scalar merge.
+ */
+static size_t intersectBlocks(const int a[], const size_t aSize, const int b[], const size_t bSize, int out[]) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+#ifdef SET_OPERATIONS_SSE2
+    while (i + 4 <= aSize && j + 4 <= bSize) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        const __m128i matches = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        const int mask = _mm_movemask_ps(_mm_castsi128_ps(matches));
+        for (int bit = 0; bit < 4; bit++) {
+            if (mask & (1 << bit)) {
+                out[k++] = a[i + bit];
+            }
+        }
+
+        const int aLast = a[i + 3];
+        const int bLast = b[j + 3];
+        i += (aLast <= bLast) ? 4 : 0;
+        j += (bLast <= aLast) ? 4 : 0;
+    }
+#endif
+    return intersectMerge(a, i, aSize, b, j, bSize, out, k);
+}
+
+/**
+ * Gallops through the large set once for every value of the small set. The galloping always starts from
+ * where the previous value was found, since the small set is sorted too.
+ */
+static size_t intersectGallop(const int small[], const size_t smallSize, const int large[], const size_t largeSize, int out[]) {
+    size_t k = 0;
+    size_t position = 0;
+    for (size_t i = 0; i < smallSize && position < largeSize; i++) {
+        position = gallop(large, largeSize, position, small[i]);
+        if (position < largeSize && large[position] == small[i]) {
+            out[k++] = small[i];
+        }
+    }
+    return k;
+}
+
+/**
+ * Picks between galloping and merging by how different the sizes of the two sets are. The output is always
+ * written in the order of a so that out may be the same array as a.
+ */
+size_t setIntersection(const int a[], const size_t aSize, const int b[], const size_t bSize, int out[]) {
+    if (!isSkewed(aSize, bSize)) {
+        return intersectBlocks(a, aSize, b, bSize, out);
+    }
+    if (aSize < bSize) {
+        return intersectGallop(a, aSize, b, bSize, out);
+    }
+
+    // a is the large set. Gallop through it for each value of b. The output position never passes the read
+    // position in a, so this is still safe when out is a.
+    size_t k = 0;
+    size_t position = 0;
+    for (size_t j = 0; j < bSize && position < aSize; j++) {
+        position = gallop(a, aSize, position, b[j]);
+        if (position < aSize && a[position] == b[j]) {
+            out[k++] = a[position];
+        }
+    }
+    return k;
+}
+
+/**
+ * For similar sizes, a merge that writes the smaller of the two front values every time and advances
+ * whichever sets it came from. The advancing is done with arithmetic on the comparison results rather than
+ * branches, since which set is smaller is close to random. For skewed sizes, gallops through the large set
+ * for every value of the small set and copies the whole run of large values before it in one go.
+ */
+size_t setUnion(const int a[], const size_t aSize, const int b[], const size_t bSize, int out[]) {
+    size_t k = 0;
+    if (!isSkewed(aSize, bSize)) {
+        size_t i = 0;
+        size_t j = 0;
+        while (i < aSize && j < bSize) {
+            const int x = a[i];
+            const int y = b[j];
+            out[k++] = (x < y) ? x : y;
+            i += (x <= y);
+            j += (y <= x);
+        }
+        out = std::copy(a + i, a + aSize, out + k);
+        out = std::copy(b + j, b + bSize, out);
+        return k + (aSize - i) + (bSize - j);
+    }
+
+    const bool aIsSmall = aSize < bSize;
+    const int* small = aIsSmall ? a : b;
+    const int* large = aIsSmall ? b : a;
+    const size_t smallSize = aIsSmall ? aSize : bSize;
+    const size_t largeSize = aIsSmall ? bSize : aSize;
+
+    size_t position = 0;
+    for (size_t i = 0; i < smallSize; i++) {
+        const size_t next = gallop(large, largeSize, position, small[i]);
+        std::copy(large + position, large + next, out + k);
+        k += next - position;
+        out[k++] = small[i];
+        position = (next < largeSize && large[next] == small[i]) ? next + 1 : next;
+    }
+    std::copy(large + position, large + largeSize, out + k);
+    return k + (largeSize - position);
+}
+
+/**
+ * Same block compare as intersectBlocks, but a block of a can match values from several blocks of b before
+ * it is done, so the matches are collected in a mask. Once the block of a is advanced past, the values that
+ * never matched are written out. The leftovers are finished with a scalar merge that skips the values of the
+ * current block that already matched.
+ */
+static size_t differenceBlocks(const int a[], const size_t aSize, const int b[], const size_t bSize, int out[]) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+    int matched = 0; // Values of the current block of a that were found in b
+#ifdef SET_OPERATIONS_SSE2
+    while (i + 4 <= aSize && j + 4 <= bSize) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        const __m128i matches = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        matched |= _mm_movemask_ps(_mm_castsi128_ps(matches));
+
+        const int aLast = a[i + 3];
+        const int bLast = b[j + 3];
+        if (aLast <= bLast) {
+            for (int bit = 0; bit < 4; bit++) {
+                if (!(matched & (1 << bit))) {
+                    out[k++] = a[i + bit];
+                }
+            }
+            matched = 0;
+            i += 4;
+        }
+        j += (bLast <= aLast) ? 4 : 0;
+    }
+#endif
+
+    const size_t blockStart = i;
+    while (i < aSize && j < bSize) {
+        const int x = a[i];
+        const int y = b[j];
+        const bool alreadyMatched = i - blockStart < 4 && (matched & (1 << (i - blockStart)));
+        if (x < y && !alreadyMatched) {
+            out[k++] = x;
+        }
+        i += (x <= y);
+        j += (y <= x);
+    }
+    for (; i < aSize; i++) {
+        if (!(i - blockStart < 4 && (matched & (1 << (i - blockStart))))) {
+            out[k++] = a[i];
+        }
+    }
+    return k;
+}
+
+/**
+ * Copies a run of a into the output. When the output is a, nothing has been removed yet while the destination is
+ * still the run itself, so the copy is skipped. Once values have been removed, the destination is in front of the
+ * run, which std::copy allows.
+ */
+static void copyRun(const int* first, const int* last, int out[]) {
+    if (out != first) {
+        std::copy(first, last, out);
+    }
+}
+
+/**
+ * Picks between galloping and merging by how different the sizes of the two sets are. When a is small, each
+ * of its values is looked up in b by galloping. When b is small, the runs of a between the values of b are
+ * found by galloping and copied in one go.
+ */
+size_t setDifference(const int a[], const size_t aSize, const int b[], const size_t bSize, int out[]) {
+    if (!isSkewed(aSize, bSize)) {
+        return differenceBlocks(a, aSize, b, bSize, out);
+    }
+
+    size_t k = 0;
+    size_t position = 0;
+    if (aSize < bSize) {
+        for (size_t i = 0; i < aSize; i++) {
+            position = gallop(b, bSize, position, a[i]);
+            if (position >= bSize || b[position] != a[i]) {
+                out[k++] = a[i];
+            }
+        }
+        return k;
+    }
+
+    for (size_t j = 0; j < bSize && position < aSize; j++) {
+        const size_t next = gallop(a, aSize, position, b[j]);
+        copyRun(a + position, a + next, out + k);
+        k += next - position;
+        position = (next < aSize && a[next] == b[j]) ? next + 1 : next;
+    }
+    copyRun(a + position, a + aSize, out + k);
+    return k + (aSize - position);
+}
+
+/**
+ * Starts with the smallest set, since the result can't be larger than it, then narrows the result down in
+ * place by intersecting it with each of the other sets. As the result shrinks, setIntersection switches to
+ * galloping on its own, so the large sets are only probed rather than walked through. Stops early once the
+ * result is empty.
+ */
+size_t setIntersectionMany(const int* const sets[], const size_t sizes[], const size_t count, int out[]) {
+    if (count == 0) {
+        return 0;
+    }
+
+    size_t smallest = 0;
+    for (size_t s = 1; s < count; s++) {
+        if (sizes[s] < sizes[smallest]) {
+            smallest = s;
+        }
+    }
+
+    size_t resultSize = sizes[smallest];
+    std::copy(sets[smallest], sets[smallest] + resultSize, out);
+    for (size_t s = 0; s < count && resultSize > 0; s++) {
+        if (s != smallest) {
+            resultSize = setIntersection(out, resultSize, sets[s], sizes[s], out);
+        }
+    }
+    return resultSize;
+}
+
+/**
+ * Runs each operation on two small sets, then times intersecting sets of similar and very different sizes
+ * against looking up each value of one set in the other with binarySearch.
+ */
+void demonstration() {
+    utility::printSectionTitle("Set Operations");
+
+    auto toString = [](const int arr[], const size_t size) {
+        std::string output;
+        for (size_t i = 0; i < size; i++) {
+            output += std::to_string(arr[i]) + ", ";
+        }
+        return output.substr(0, output.size() - 2);
+    };
+
+    const int a[] = { 1, 3, 4, 7, 9, 12, 15, 20, 21, 30 };
+    const int b[] = { 2, 3, 7, 8, 12, 20, 25, 30 };
+    const int c[] = { 3, 12, 25, 30, 40 };
+    constexpr size_t A_SIZE = sizeof(a) / sizeof(a[0]);
+    constexpr size_t B_SIZE = sizeof(b) / sizeof(b[0]);
+    constexpr size_t C_SIZE = sizeof(c) / sizeof(c[0]);
+    int out[A_SIZE + B_SIZE];
+    LOG("Set a: ", toString(a, A_SIZE), "\nSet b: ", toString(b, B_SIZE), "\nSet c: ", toString(c, C_SIZE), "\n");
+    LOG("a intersect b: ", toString(out, setIntersection(a, A_SIZE, b, B_SIZE, out)), "\n");
+    LOG("a union b: ", toString(out, setUnion(a, A_SIZE, b, B_SIZE, out)), "\n");
+    LOG("a minus b: ", toString(out, setDifference(a, A_SIZE, b, B_SIZE, out)), "\n");
+    const int* sets[] = { a, b, c };
+    const size_t sizes[] = { A_SIZE, B_SIZE, C_SIZE };
+    LOG("a intersect b intersect c: ", toString(out, setIntersectionMany(sets, sizes, 3, out)), "\n");
+
+    // Random sets with every value having a 1 in 2 chance of being present
+    std::mt19937 gen(12345);
+    auto makeSet = [&gen](const size_t size) {
+        std::uniform_int_distribution<int> gap(1, 3);
+        std::vector<int> set(size);
+        int value = 0;
+        for (auto& v : set) {
+            value += gap(gen);
+            v = value;
+        }
+        return set;
+    };
+
+    for (const size_t smallSize : { static_cast<size_t>(1000000), static_cast<size_t>(1000) }) {
+        const std::vector<int> large = makeSet(1000000);
+        std::vector<int> small = makeSet(smallSize);
+        for (auto& v : small) {
+            v *= 1000000 / static_cast<int>(smallSize); // Spread the small set over the same range as the large one
+        }
+        std::vector<int> result(small.size());
+
+        auto start = std::chrono::steady_clock::now();
+        size_t found = 0;
+        for (const int v : small) {
+            if (binary_search::binarySearch(large, v) != -1) {
+                result[found++] = v;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        LOG("Intersecting ", smallSize, " with 1000000 values using binarySearch: ", std::chrono::duration<double, std::micro>(end - start).count(), " us, ", found, " in common\n");
+
+        start = std::chrono::steady_clock::now();
+        found = setIntersection(small.data(), small.size(), large.data(), large.size(), result.data());
+        end = std::chrono::steady_clock::now();
+        LOG("Intersecting ", smallSize, " with 1000000 values using setIntersection: ", std::chrono::duration<double, std::micro>(end - start).count(), " us, ", found, " in common\n");
+    }
+}
+
+} // namespace set_operations
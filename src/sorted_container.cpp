@@ -0,0 +1,255 @@
+/**
+ * @file sorted_container.cpp
+ * @brief Source file for the log-structured sorted array.
+ */
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include "sorted_container.h"
+#include "binary_search.h"
+#include "merge_sort.h"
+#include "logger/log.h"
+#include "utility.h"
+
+namespace sorted_container {
+
+/**
+ * Appending to the unsorted buffer is O(1). Once it's full, it's sorted (it's small, so this is cheap) and added
+ * to the levels as one run.
+ */
+void LogStructuredArray::insert(const int value) {
+    buffer.push_back(value);
+    count++;
+    if (buffer.size() == BUFFER_SIZE) {
+        std::sort(buffer.begin(), buffer.end());
+        addRun(std::move(buffer));
+        buffer.clear();
+    }
+}
+
+/**
+ * Small batches go through the buffer like single inserts. Batches of at least a full buffer are sorted on their
+ * own and added as a run, so they don't pass through the buffer in BUFFER_SIZE pieces.
+ */
+void LogStructuredArray::insert(const std::vector<int>& values) {
+    if (values.size() < BUFFER_SIZE) {
+        for (const int v : values) {
+            insert(v);
+        }
+        return;
+    }
+
+    std::vector<int> run = values;
+    std::sort(run.begin(), run.end());
+    count += run.size();
+    addRun(std::move(run));
+}
+
+/**
+ * Works like carrying in binary addition. Walks up the levels, collecting every non-empty level on the way, until
+ * it reaches an empty level big enough for the run plus everything collected. The run and the collected levels are
+ * then merged into that level in one pass with merge_sort::multiwayMerge, and the collected levels are emptied.
+ */
+void LogStructuredArray::addRun(std::vector<int> run) {
+    size_t total = run.size();
+    size_t target = 0;
+    size_t capacity = BUFFER_SIZE;
+    while (true) {
+        if (target == levels.size()) {
+            levels.emplace_back();
+        }
+        if (levels[target].empty() && capacity >= total) {
+            break;
+        }
+        total += levels[target].size();
+        target++;
+        capacity *= 2;
+    }
+
+    if (total == run.size()) {
+        levels[target] = std::move(run);
+        return;
+    }
+
+    std::vector<const int*> runs = { run.data() };
+    std::vector<size_t> sizes = { run.size() };
+    for (size_t level = 0; level < target; level++) {
+        if (!levels[level].empty()) {
+            runs.push_back(levels[level].data());
+            sizes.push_back(levels[level].size());
+        }
+    }
+    levels[target].resize(total);
+    merge_sort::multiwayMerge(runs.data(), sizes.data(), runs.size(), levels[target].data());
+    for (size_t level = 0; level < target; level++) {
+        levels[level].clear();
+    }
+}
+
+/**
+ * The position of a value in the sorted order of the whole container is the amount of values less than it, which
+ * is the sum of the lower bounds of the value in every level, plus the values less than it in the buffer. The value
+ * was found if it sits at its lower bound in any level, or is anywhere in the buffer.
+ */
+int LogStructuredArray::find(const int target) const {
+    size_t position = 0;
+    bool found = false;
+    for (const auto& level : levels) {
+        if (level.empty()) {
+            continue;
+        }
+        const size_t lower = binary_search::lowerBound(level.data(), target, 0, static_cast<int>(level.size()) - 1);
+        position += lower;
+        found |= (lower < level.size() && level[lower] == target);
+    }
+    for (const int v : buffer) {
+        position += (v < target);
+        found |= (v == target);
+    }
+
+    return found ? static_cast<int>(position) : -1;
+}
+
+/**
+ * Checks the buffer first, since recently inserted values are the most likely to be looked up, then each level
+ * with binarySearch.
+ */
+bool LogStructuredArray::contains(const int target) const {
+    if (std::find(buffer.begin(), buffer.end(), target) != buffer.end()) {
+        return true;
+    }
+    for (const auto& level : levels) {
+        if (!level.empty() && binary_search::binarySearch(level, target) != -1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t LogStructuredArray::size() const {
+    return count;
+}
+
+std::vector<int> LogStructuredArray::toVector() const {
+    std::vector<int> sortedBuffer = buffer;
+    std::sort(sortedBuffer.begin(), sortedBuffer.end());
+
+    std::vector<const int*> runs = { sortedBuffer.data() };
+    std::vector<size_t> sizes = { sortedBuffer.size() };
+    for (const auto& level : levels) {
+        runs.push_back(level.data());
+        sizes.push_back(level.size());
+    }
+
+    std::vector<int> result(count);
+    merge_sort::multiwayMerge(runs.data(), sizes.data(), runs.size(), result.data());
+    return result;
+}
+
+/**
+ * Runs the operations in rounds of 1000: 900 lookups, then 100 inserts. The std::vector gets each round's inserts
+ * appended as one batch and is then re-sorted, so it's ready for the next round's lookups. The LogStructuredArray
+ * takes the same inserts one at a time. Lookups and inserts are timed separately.
+ */
+void mixedWorkload(const size_t initialSize, const size_t operations) {
+    constexpr size_t ROUND = 1000;
+    constexpr size_t WRITES_PER_ROUND = ROUND / 10;
+
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(std::min<size_t>((initialSize + operations) * 4, 1000000000)));
+    std::vector<int> initial(initialSize);
+    for (auto& v : initial) {
+        v = dist(gen);
+    }
+
+    std::vector<int> sortedVector = initial;
+    std::sort(sortedVector.begin(), sortedVector.end());
+    LogStructuredArray container;
+    container.insert(initial);
+
+    double vectorReadNs = 0;
+    double vectorWriteNs = 0;
+    double containerReadNs = 0;
+    double containerWriteNs = 0;
+    size_t vectorFound = 0;
+    size_t containerFound = 0;
+    std::vector<int> lookups(ROUND - WRITES_PER_ROUND);
+    std::vector<int> writes(WRITES_PER_ROUND);
+    const size_t rounds = operations / ROUND;
+
+    for (size_t round = 0; round < rounds; round++) {
+        for (auto& v : lookups) {
+            v = dist(gen);
+        }
+        for (auto& v : writes) {
+            v = dist(gen);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (const int v : lookups) {
+            vectorFound += (binary_search::binarySearch(sortedVector, v) != -1);
+        }
+        auto end = std::chrono::steady_clock::now();
+        vectorReadNs += std::chrono::duration<double, std::nano>(end - start).count();
+
+        start = std::chrono::steady_clock::now();
+        sortedVector.insert(sortedVector.end(), writes.begin(), writes.end());
+        std::sort(sortedVector.begin(), sortedVector.end());
+        end = std::chrono::steady_clock::now();
+        vectorWriteNs += std::chrono::duration<double, std::nano>(end - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (const int v : lookups) {
+            containerFound += (container.find(v) != -1);
+        }
+        end = std::chrono::steady_clock::now();
+        containerReadNs += std::chrono::duration<double, std::nano>(end - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (const int v : writes) {
+            container.insert(v);
+        }
+        end = std::chrono::steady_clock::now();
+        containerWriteNs += std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    const double totalReads = static_cast<double>(std::max<size_t>(rounds * lookups.size(), 1));
+    const double totalWrites = static_cast<double>(std::max<size_t>(rounds * writes.size(), 1));
+    LOG("Mixed workload of ", rounds * ROUND, " operations (90% lookups, 10% inserts) starting from ", initialSize, " values\n");
+    LOG("Sorted std::vector re-sorted per batch: ", vectorReadNs / totalReads, " ns per lookup, ", totalWrites / vectorWriteNs * 1e9, " inserts per second, ", vectorFound, " found\n");
+    LOG("LogStructuredArray: ", containerReadNs / totalReads, " ns per lookup, ", totalWrites / containerWriteNs * 1e9, " inserts per second, ", containerFound, " found\n");
+}
+
+/**
+ * Inserts a few values one at a time, shows the sorted result and looks some of them up, then runs the mixed
+ * workload comparison.
+ */
+void demonstration() {
+    utility::printSectionTitle("Log-Structured Sorted Array");
+
+    LogStructuredArray container;
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> dist(0, 999);
+    for (int i = 0; i < 200; i++) {
+        container.insert(dist(gen));
+    }
+    container.insert(500);
+
+    const std::vector<int> values = container.toVector();
+    std::string contents;
+    for (auto v : values) {
+        contents += std::to_string(v) + ", ";
+    }
+    contents = contents.substr(0, contents.size() - 2);
+    LOG("Inserted ", container.size(), " values one at a time. Sorted contents:\n", contents, "\n");
+
+    for (const int target : { 500, 1000 }) {
+        const int result = container.find(target);
+        LOG("Looking for ", target, ". Result: ", ((result != -1) ? "found at index " + std::to_string(result) : "not found"), "\n");
+    }
+
+    mixedWorkload(200000, 100000);
+}
+
+} // namespace sorted_container
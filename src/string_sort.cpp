@@ -0,0 +1,378 @@
+/**
+ * @file string_sort.cpp
+ * @brief Source file for the string sorting algorithms.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include "string_sort.h"
+#include "logger/log.h"
+#include "utility.h"
+
+namespace string_sort {
+
+constexpr size_t INSERTION_SORT_SIZE = 32; /**< Sub-arrays smaller than this are finished with a comparison sort, which is faster for so few strings */
+
+void StringArena::add(const std::string_view s) {
+    characters.append(s.data(), s.size());
+    ends.push_back(characters.size());
+}
+
+std::vector<std::string_view> StringArena::views() const {
+    std::vector<std::string_view> result(size());
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = std::string_view(characters.data() + ends[i], ends[i + 1] - ends[i]);
+    }
+    return result;
+}
+
+size_t StringArena::size() const {
+    return ends.size() - 1;
+}
+
+/**
+ * Gets the character at depth as a bucket number. A string that has already ended goes to bucket 0, which sorts
+ * before every real character. Real characters are treated as unsigned, like std::string's operator< does.
+ */
+static int charAt(const std::string_view s, const size_t depth) {
+    return (depth < s.size()) ? static_cast<unsigned char>(s[depth]) + 1 : 0;
+}
+
+/**
+ * Every string in the range is known to share its first depth characters, so only the rest of them are compared.
+ */
+static void insertionSort(std::string_view strings[], const size_t size, const size_t depth) {
+    for (size_t i = 1; i < size; i++) {
+        const std::string_view current = strings[i];
+        const std::string_view currentRest = current.substr(std::min(depth, current.size()));
+        size_t j = i;
+        while (j > 0 && currentRest < strings[j - 1].substr(std::min(depth, strings[j - 1].size()))) {
+            strings[j] = strings[j - 1];
+            j--;
+        }
+        strings[j] = current;
+    }
+}
+
+/**
+ * Counts how many strings have each character at depth, then moves every string into its bucket through the aux
+ * array. Each bucket is then sorted on its own at the next depth, except bucket 0, whose strings all ended and are
+ * equal. When every string lands in the same bucket (a shared prefix, like "https://"), nothing needs to move, so it
+ * goes straight to the next depth without recursing.
+ *
+ * Only the smaller buckets are recursed into. The largest one is sorted by looping, so every call gets at most half
+ * the strings of its caller and the recursion is never more than log2(size) deep, no matter how long the strings are.
+ */
+static void msdRadixSort(std::string_view strings[], std::string_view aux[], size_t size, size_t depth) {
+    while (size >= INSERTION_SORT_SIZE) {
+        size_t counts[257] = { 0 };
+        size_t starts[257];
+        for (size_t i = 0; i < size; i++) {
+            counts[charAt(strings[i], depth)]++;
+        }
+
+        const int first = charAt(strings[0], depth);
+        if (counts[first] == size) {
+            if (first == 0) {
+                return; // Every string ended, so they're all equal
+            }
+            depth++;
+            continue;
+        }
+
+        size_t start = 0;
+        for (int bucket = 0; bucket < 257; bucket++) {
+            starts[bucket] = start;
+            start += counts[bucket];
+        }
+        for (size_t i = 0; i < size; i++) {
+            aux[starts[charAt(strings[i], depth)]++] = strings[i];
+        }
+        std::copy(aux, aux + size, strings);
+
+        // starts now holds the end of each bucket
+        int largest = 1;
+        for (int bucket = 2; bucket < 257; bucket++) {
+            if (counts[bucket] > counts[largest]) {
+                largest = bucket;
+            }
+        }
+        for (int bucket = 1; bucket < 257; bucket++) {
+            if (bucket != largest && counts[bucket] > 1) {
+                msdRadixSort(strings + starts[bucket] - counts[bucket], aux, counts[bucket], depth + 1);
+            }
+        }
+
+        strings += starts[largest] - counts[largest];
+        size = counts[largest];
+        depth++;
+    }
+
+    insertionSort(strings, size, depth);
+}
+
+/**
+ * The aux array is allocated once here and shared by every level of the recursion.
+ */
+void msdRadixSort(std::string_view strings[], const size_t size) {
+    std::vector<std::string_view> aux(size);
+    msdRadixSort(strings, aux.data(), size, 0);
+}
+
+/**
+ * Three-way partitions the strings by their character at depth, around the median of three characters. The strings
+ * less than and greater than the pivot are sorted at the same depth, since they still differ there. The strings equal
+ * to the pivot share one more character, so they're sorted at the next depth. If the pivot is the end of the string,
+ * the equal strings have all ended and are done. Only the two smaller parts are recursed into, and the largest is
+ * sorted by looping, so the recursion is at most log2(size) deep.
+ */
+static void characterQuickSort(std::string_view strings[], size_t size, size_t depth) {
+    while (size >= INSERTION_SORT_SIZE) {
+        const int a = charAt(strings[0], depth);
+        const int b = charAt(strings[size / 2], depth);
+        const int c = charAt(strings[size - 1], depth);
+        const int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        // Dijkstra's three-way partition: [0, less) < pivot, [less, i) == pivot, (greater, size) > pivot
+        size_t less = 0;
+        size_t i = 0;
+        size_t greater = size;
+        while (i < greater) {
+            const int ch = charAt(strings[i], depth);
+            if (ch < pivot) {
+                std::swap(strings[less++], strings[i++]);
+            }
+            else if (ch > pivot) {
+                std::swap(strings[i], strings[--greater]);
+            }
+            else {
+                i++;
+            }
+        }
+
+        // Recurse into the two smaller parts and loop on the largest, so the recursion is never more than log2(size)
+        // deep. If the pivot is the end of the string, the equal part is already done.
+        const size_t equalSize = (pivot == 0) ? 0 : greater - less;
+        const size_t greaterSize = size - greater;
+        if (less >= equalSize && less >= greaterSize) {
+            characterQuickSort(strings + less, equalSize, depth + 1);
+            characterQuickSort(strings + greater, greaterSize, depth);
+            size = less;
+        }
+        else if (greaterSize >= equalSize) {
+            characterQuickSort(strings, less, depth);
+            characterQuickSort(strings + less, equalSize, depth + 1);
+            strings += greater;
+            size = greaterSize;
+        }
+        else {
+            characterQuickSort(strings, less, depth);
+            characterQuickSort(strings + greater, greaterSize, depth);
+            strings += less;
+            size = equalSize;
+            depth++;
+        }
+    }
+
+    insertionSort(strings, size, depth);
+}
+
+/**
+ * A string along with its next 8 characters starting at some depth, packed big-endian into one number so that
+ * comparing the numbers compares the characters.
+ */
+struct CachedString {
+    uint64_t prefix;
+    std::string_view str;
+};
+
+/**
+ * Packs the 8 characters of s starting at depth. Characters past the end of the string are filled with 0.
+ */
+static uint64_t loadPrefix(const std::string_view s, const size_t depth) {
+    uint64_t prefix = 0;
+    for (size_t k = 0; k < 8; k++) {
+        prefix <<= 8;
+        if (depth + k < s.size()) {
+            prefix |= static_cast<unsigned char>(s[depth + k]);
+        }
+    }
+    return prefix;
+}
+
+/**
+ * Same partitioning as characterQuickSort, but on the cached 8-character prefixes instead of single characters. The
+ * equal group moves 8 characters deeper, and only its prefixes are reloaded. Strings that end within the current 8
+ * characters are a prefix of every other string in the equal group (the 0 padding matched the other strings), so they
+ * go first, ordered by length, and are done.
+ */
+static void cachedQuickSort(CachedString strings[], size_t size, size_t depth) {
+    while (size > 1) {
+        if (size < INSERTION_SORT_SIZE) {
+            std::sort(strings, strings + size, [depth](const CachedString& x, const CachedString& y) {
+                if (x.prefix != y.prefix) {
+                    return x.prefix < y.prefix;
+                }
+                return x.str.substr(std::min(depth, x.str.size())) < y.str.substr(std::min(depth, y.str.size()));
+            });
+            return;
+        }
+
+        const uint64_t a = strings[0].prefix;
+        const uint64_t b = strings[size / 2].prefix;
+        const uint64_t c = strings[size - 1].prefix;
+        const uint64_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        size_t less = 0;
+        size_t i = 0;
+        size_t greater = size;
+        while (i < greater) {
+            const uint64_t p = strings[i].prefix;
+            if (p < pivot) {
+                std::swap(strings[less++], strings[i++]);
+            }
+            else if (p > pivot) {
+                std::swap(strings[i], strings[--greater]);
+            }
+            else {
+                i++;
+            }
+        }
+
+        // Move the strings that ended to the front of the equal group
+        CachedString* equal = strings + less;
+        CachedString* unfinished = std::partition(equal, strings + greater, [depth](const CachedString& s) {
+            return s.str.size() <= depth + 8;
+        });
+        std::sort(equal, unfinished, [](const CachedString& x, const CachedString& y) {
+            return x.str.size() < y.str.size();
+        });
+        const size_t unfinishedSize = strings + greater - unfinished;
+        for (size_t k = 0; k < unfinishedSize; k++) {
+            unfinished[k].prefix = loadPrefix(unfinished[k].str, depth + 8);
+        }
+
+        // Recurse into the two smaller parts and loop on the largest, so the recursion is never more than log2(size)
+        // deep, even when every string has a different prefix
+        const size_t greaterSize = size - greater;
+        if (less >= unfinishedSize && less >= greaterSize) {
+            cachedQuickSort(unfinished, unfinishedSize, depth + 8);
+            cachedQuickSort(strings + greater, greaterSize, depth);
+            size = less;
+        }
+        else if (greaterSize >= unfinishedSize) {
+            cachedQuickSort(strings, less, depth);
+            cachedQuickSort(unfinished, unfinishedSize, depth + 8);
+            strings += greater;
+            size = greaterSize;
+        }
+        else {
+            cachedQuickSort(strings, less, depth);
+            cachedQuickSort(strings + greater, greaterSize, depth);
+            strings = unfinished;
+            size = unfinishedSize;
+            depth += 8;
+        }
+    }
+}
+
+void multikeyQuickSort(std::string_view strings[], const size_t size, const bool cachePrefixes) {
+    if (!cachePrefixes) {
+        characterQuickSort(strings, size, 0);
+        return;
+    }
+
+    std::vector<CachedString> cached(size);
+    for (size_t i = 0; i < size; i++) {
+        cached[i] = { loadPrefix(strings[i], 0), strings[i] };
+    }
+    cachedQuickSort(cached.data(), size, 0);
+    for (size_t i = 0; i < size; i++) {
+        strings[i] = cached[i].str;
+    }
+}
+
+/**
+ * Generates URL-like strings that share long prefixes, which is where comparison sorts waste the most time. Every
+ * sort gets the same input, and the results are checked against std::sort.
+ */
+void compareSorts(const size_t count) {
+    const std::string hosts[] = { "https://www.example.com/", "https://www.example.org/", "https://api.example.com/v1/" };
+    const std::string paths[] = { "users/", "items/", "search?q=", "static/images/" };
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<int> length(4, 16);
+
+    std::vector<std::string> heapStrings(count);
+    StringArena arena;
+    for (auto& s : heapStrings) {
+        s = hosts[gen() % 3] + paths[gen() % 4];
+        const int extra = length(gen);
+        for (int k = 0; k < extra; k++) {
+            s += static_cast<char>(letter(gen));
+        }
+        arena.add(s);
+    }
+    const std::vector<std::string_view> input = arena.views();
+    LOG("Sorting ", count, " URL-like strings\n");
+
+    auto start = std::chrono::steady_clock::now();
+    std::sort(heapStrings.begin(), heapStrings.end());
+    auto end = std::chrono::steady_clock::now();
+    LOG("std::sort on std::string: ", std::chrono::duration<double, std::milli>(end - start).count(), " ms\n");
+
+    std::vector<std::string_view> expected = input;
+    start = std::chrono::steady_clock::now();
+    std::sort(expected.begin(), expected.end());
+    end = std::chrono::steady_clock::now();
+    LOG("std::sort on arena std::string_view: ", std::chrono::duration<double, std::milli>(end - start).count(), " ms\n");
+
+    auto timeSort = [&](const std::string& name, auto&& sort) {
+        std::vector<std::string_view> strings = input;
+        const auto start = std::chrono::steady_clock::now();
+        sort(strings.data(), strings.size());
+        const auto end = std::chrono::steady_clock::now();
+        LOG(name, ": ", std::chrono::duration<double, std::milli>(end - start).count(), " ms, ", ((strings == expected) ? "same result" : "DIFFERENT result"), "\n");
+    };
+    timeSort("msdRadixSort", [](std::string_view s[], size_t n) { msdRadixSort(s, n); });
+    timeSort("multikeyQuickSort", [](std::string_view s[], size_t n) { multikeyQuickSort(s, n, false); });
+    timeSort("multikeyQuickSort with cached prefixes", [](std::string_view s[], size_t n) { multikeyQuickSort(s, n, true); });
+}
+
+/**
+ * Sorts a few words with each algorithm, then compares them against std::sort on a larger set of strings.
+ */
+void demonstration() {
+    utility::printSectionTitle("String Sorting");
+
+    StringArena arena;
+    for (const char* word : { "banana", "apple", "band", "ban", "apply", "bandana", "", "app", "cherry", "apple" }) {
+        arena.add(word);
+    }
+
+    auto toString = [](const std::vector<std::string_view>& strings) {
+        std::string output;
+        for (const auto s : strings) {
+            output += "\"";
+            output += s;
+            output += "\", ";
+        }
+        return output.substr(0, output.size() - 2);
+    };
+
+    std::vector<std::string_view> words = arena.views();
+    LOG("Unsorted: ", toString(words), "\n");
+    msdRadixSort(words.data(), words.size());
+    LOG("MSD Radix Sort: ", toString(words), "\n");
+    words = arena.views();
+    multikeyQuickSort(words.data(), words.size(), false);
+    LOG("Multikey Quick Sort: ", toString(words), "\n");
+    words = arena.views();
+    multikeyQuickSort(words.data(), words.size(), true);
+    LOG("Multikey Quick Sort with cached prefixes: ", toString(words), "\n");
+
+    compareSorts(200000);
+}
+
+} // namespace string_sort
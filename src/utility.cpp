@@ -6,13 +6,21 @@
 
 namespace utility {
 
-    void printSectionTitle(const std::string sectionName) {
-        std::string output;
+    /**
+     * The title is built in one string that's reserved at its final size first, so the appends never reallocate. The
+     * name is only viewed, so passing a literal doesn't allocate a temporary std::string.
+     */
+    void printSectionTitle(const std::string_view sectionName, std::pmr::memory_resource* resource) {
+        constexpr size_t BORDER_SIZE = 65; // One line of asterisks and its newline
+        std::pmr::string output(resource);
+        output.reserve(4 * BORDER_SIZE + sectionName.size() + 24);
         output += "\n";
         output += "\n";
         output += "****************************************************************\n";
         output += "****************************************************************\n";
-        output += "STARTING SECTION: \"" + sectionName + "\"\n";
+        output += "STARTING SECTION: \"";
+        output += sectionName;
+        output += "\"\n";
         output += "****************************************************************\n";
         output += "****************************************************************\n";
         output += "\n";